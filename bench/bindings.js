@@ -0,0 +1,31 @@
+// node --expose-gc bindings.js path/to/bindings_bench.node
+// Runs with --expose-gc, so RequestGarbageCollectionForTesting is allowed
+const {m} = require(require('path').resolve(process.argv[2]));
+
+const N = 5000, modules = 20;
+
+// Median GC time of 5 runs, handles don't change between runs
+function stats() {
+    const runs = [];
+    for (let i = 0; i < 5; ++i) runs.push(m.stats());
+    return [runs[0][0], runs.map(r => r[1]).sort((a, b) => a - b)[2]];
+}
+
+const rss = () => process.memoryUsage().rss;
+
+const [handles0, gc0] = stats();
+const rss0 = rss();
+const t0 = process.hrtime.bigint();
+const live = [];
+for (let i = 0; i < modules; ++i) live.push(m.bind(N));
+const bindMs = Number(process.hrtime.bigint() - t0) / 1e6;
+const [handles1, gc1] = stats();
+const rss1 = rss();
+
+const count = N * modules;
+console.log(`bound ${count} functions (${modules} modules) in ${bindMs.toFixed(0)} ms`);
+console.log(`RSS +${((rss1 - rss0) / 1048576).toFixed(1)} MB (${((rss1 - rss0) / count).toFixed(0)} bytes per function)`);
+if (handles0 >= 0) {
+    console.log(`global handles +${((handles1 - handles0) / 1024).toFixed(0)} KB`);
+}
+console.log(`full GC ${gc0.toFixed(2)} ms before, ${gc1.toFixed(2)} ms with functions alive`);
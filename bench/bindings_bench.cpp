@@ -0,0 +1,53 @@
+// Cost of binding data: memory and global handles held by bound functions, and GC time with them alive
+
+#include <node.h>
+#include <v8bind/v8bind.hpp>
+
+#include <chrono>
+#include <string>
+#include <vector>
+
+namespace {
+
+// Module with n functions, each has own payload (captured name, half of them are overloaded)
+v8::Local<v8::Object> Bind(int n) {
+    auto isolate = v8::Isolate::GetCurrent();
+    v8b::Module module(isolate);
+    for (int i = 0; i < n; ++i) {
+        auto name = "f" + std::to_string(i);
+        auto f = [name](int x) { return x + static_cast<int>(name.size()); };
+        if (i % 2) {
+            module.Function(name, f, [name](const std::string &s) { return name + s; });
+        } else {
+            module.Function(name, f);
+        }
+    }
+    return module.NewInstance();
+}
+
+// Used global handles in bytes and time of full GC in ms,
+// handle statistics are available since V8 8.4, -1 otherwise
+std::vector<double> Stats() {
+    auto isolate = v8::Isolate::GetCurrent();
+    auto t0 = std::chrono::steady_clock::now();
+    isolate->RequestGarbageCollectionForTesting(v8::Isolate::kFullGarbageCollection);
+    auto gc_ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - t0).count();
+
+    double handles = -1;
+#if V8_MAJOR_VERSION > 8 || (V8_MAJOR_VERSION == 8 && V8_MINOR_VERSION >= 4)
+    v8::HeapStatistics statistics;
+    isolate->GetHeapStatistics(&statistics);
+    handles = static_cast<double>(statistics.used_global_handles_size());
+#endif
+    return { handles, gc_ms };
+}
+
+}
+
+NODE_MODULE_INIT() {
+    auto isolate = context->GetIsolate();
+
+    v8b::Module bindings(isolate);
+    bindings.Function("bind", &Bind).Function("stats", &Stats);
+    exports->Set(context, v8b::ToV8(isolate, "m"), bindings.NewInstance()).Check();
+}
@@ -0,0 +1,27 @@
+// node --expose-gc registry.js path/to/registry_bench.node
+const {m} = require(require('path').resolve(process.argv[2]));
+
+function time(name, n, f) {
+    f(Math.min(n, 10000));
+    gc();
+    const t0 = process.hrtime.bigint();
+    f(n);
+    gc();
+    const ms = Number(process.hrtime.bigint() - t0) / 1e6;
+    console.log(`${name}: ${(n / ms / 1000).toFixed(2)} Mops/s`);
+}
+
+const N = 2000000;
+time('wrap+collect from JS', N, n => { for (let i = 0; i < n; ++i) new m.Leaf(); });
+const live = [];
+for (let i = 0; i < 100000; ++i) live.push(new m.Leaf());
+time('find by base pointer (100k live)', N, n => {
+    let s = 0;
+    for (let i = 0; i < n; ++i) s += m.same(live[i % live.length]) === live[i % live.length];
+});
+
+const runs = [];
+for (let i = 0; i < 5; ++i) runs.push(m.native(200000));
+const median = k => runs.map(r => r[k]).sort((a, b) => a - b)[2].toFixed(2);
+console.log(`native (200k objects, median of 5): wrap ${median(0)} Mops/s, ` +
+    `find by base pointer ${median(1)} Mops/s, remove ${median(2)} Mops/s`);
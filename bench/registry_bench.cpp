@@ -0,0 +1,78 @@
+// Object registry throughput: wrapping, lookup by (base) pointer and removal of wrapped objects
+
+#include <node.h>
+#include <v8bind/v8bind.hpp>
+
+#include <chrono>
+#include <vector>
+
+namespace {
+
+struct Pad { double pad = 0; };
+struct Base { virtual ~Base() = default; int b = 7; };
+struct Mid : Pad, Base { int m = 11; };
+struct Leaf : Mid { int l = 13; };
+
+Base *Same(Base *b) {
+    return b;
+}
+
+// Returns Mops/s of native wrap, find by base pointer (10 rounds) and remove
+std::vector<double> Native(int n) {
+    auto isolate = v8::Isolate::GetCurrent();
+    auto &leaf = v8b::ClassManagerPool::Get<Leaf>(isolate);
+    auto &base = v8b::ClassManagerPool::Get<Base>(isolate);
+
+    std::vector<Leaf *> objects;
+    for (int i = 0; i < n; ++i) {
+        objects.push_back(new Leaf());
+    }
+    std::vector<v8::Global<v8::Object>> wrapped(n);
+
+    using Clock = std::chrono::steady_clock;
+    auto t0 = Clock::now();
+    for (int i = 0; i < n; i += 1000) {
+        v8::HandleScope scope(isolate);
+        for (int j = i; j < i + 1000 && j < n; ++j) {
+            wrapped[j].Reset(isolate, leaf.WrapObject(objects[j], true));
+        }
+    }
+    auto t1 = Clock::now();
+    size_t found = 0;
+    for (int round = 0; round < 10; ++round) {
+        v8::HandleScope scope(isolate);
+        for (int j = 0; j < n; ++j) {
+            found += !base.FindObject(static_cast<Base *>(objects[j])).IsEmpty();
+        }
+    }
+    auto t2 = Clock::now();
+    for (int j = 0; j < n; ++j) {
+        leaf.RemoveObject(objects[j]);
+    }
+    auto t3 = Clock::now();
+
+    auto mops = [](double count, Clock::duration d) {
+        return count / std::chrono::duration<double, std::micro>(d).count();
+    };
+    return { mops(n, t1 - t0), found == 10u * n ? mops(10.0 * n, t2 - t1) : 0.0, mops(n, t3 - t2) };
+}
+
+}
+
+NODE_MODULE_INIT() {
+    auto isolate = context->GetIsolate();
+
+    v8b::Class<Base> base(isolate);
+    v8b::Class<Mid> mid(isolate);
+    mid.Inherit<Base>();
+    v8b::Class<Leaf> leaf(isolate);
+    leaf.Inherit<Mid>().Constructor<std::tuple<>>();
+
+    v8b::Module bindings(isolate);
+    bindings.Class("Leaf", leaf).Function("same", &Same).Function("native", &Native);
+    exports->Set(context, v8b::ToV8(isolate, "m"), bindings.NewInstance()).Check();
+
+    node::AddEnvironmentCleanupHook(isolate, [](void *isolate) {
+        v8b::ClassManagerPool::RemoveAll(static_cast<v8::Isolate *>(isolate));
+    }, isolate);
+}
@@ -0,0 +1,31 @@
+// node transcode.js path/to/transcode_bench.node
+const {m} = require(require('path').resolve(process.argv[2]));
+
+// Best of 7 runs, 10 calls each, returns ms per call
+function time(f) {
+    let best = Infinity;
+    for (let r = 0; r < 7; ++r) {
+        const t = process.hrtime.bigint();
+        for (let i = 0; i < 10; ++i) f();
+        best = Math.min(best, Number(process.hrtime.bigint() - t) / 1e6 / 10);
+    }
+    return best;
+}
+
+// Samples are 1M code points, 4 MB as UTF-32
+const mb = 4;
+const names = ['latin1', 'utf16 bmp', 'utf16 astral'];
+for (let k = 0; k < 3; ++k) {
+    const s = m.u32Out(k);
+    const toNative = time(() => m.u32In(s)), toJS = time(() => m.u32Out(k));
+    console.log(`${names[k].padEnd(13)} JS->u32 ${toNative.toFixed(2)} ms (${(mb / toNative * 1000).toFixed(0)} MB/s)  ` +
+        `u32->JS ${toJS.toFixed(2)} ms (${(mb / toJS * 1000).toFixed(0)} MB/s)`);
+}
+
+const pairs = ['latin1->utf32', 'utf16->utf32 bmp', 'utf16->utf32 astral',
+    'utf32->latin1', 'utf32->utf16 bmp', 'utf32->utf16 astral'];
+// Transcoders of every instruction set supported by CPU, in MB/s
+const isas = ['scalar', 'sse4.1', 'avx2'].slice(0, m.isa() + 1);
+const rows = isas.map((_, isa) => m.native(100, isa));
+console.log(`transcoder${' '.repeat(20)}${isas.map(n => n.padStart(8)).join('')}`);
+pairs.forEach((p, i) => console.log(`${p.padEnd(30)}${rows.map(r => r[i].toFixed(0).padStart(8)).join('')}`));
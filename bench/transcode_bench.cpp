@@ -0,0 +1,110 @@
+// UTF-32 string conversion throughput for every V8 string representation
+
+#include <node.h>
+#include <v8bind/v8bind.hpp>
+
+#include <chrono>
+#include <string>
+#include <vector>
+
+namespace {
+
+// Latin-1, UTF-16 inside BMP, UTF-16 with surrogate pairs (every 4th code point)
+std::u32string samples[3];
+
+size_t U32In(const std::u32string &s) {
+    return s.size();
+}
+
+const std::u32string &U32Out(int kind) {
+    return samples[kind];
+}
+
+namespace tc = v8b::impl::transcode;
+
+// Transcoders of one instruction set
+struct Kernels {
+    void (*latin1_to_utf32)(const uint8_t *, size_t, char32_t *);
+    size_t (*utf16_to_utf32)(const uint16_t *, size_t, char32_t *);
+    void (*utf32_to_latin1)(const char32_t *, size_t, uint8_t *);
+    size_t (*utf32_to_utf16)(const char32_t *, size_t, uint16_t *);
+};
+
+// Indexed by instruction set: scalar, SSE4.1, AVX2
+const Kernels kernels[] = {
+    {tc::scalar::Latin1ToUtf32, tc::scalar::Utf16ToUtf32, tc::scalar::Utf32ToLatin1, tc::scalar::Utf32ToUtf16},
+#if V8B_TRANSCODE_SIMD
+    {tc::sse41::Latin1ToUtf32, tc::sse41::Utf16ToUtf32, tc::sse41::Utf32ToLatin1, tc::sse41::Utf32ToUtf16},
+    {tc::avx2::Latin1ToUtf32, tc::avx2::Utf16ToUtf32, tc::avx2::Utf32ToLatin1, tc::avx2::Utf32ToUtf16},
+#endif
+};
+
+// Best instruction set used by conversions, kernels up to it can be measured
+int Isa() {
+#if V8B_TRANSCODE_SIMD
+    return static_cast<int>(tc::GetIsa());
+#else
+    return 0;
+#endif
+}
+
+// Throughput of transcoder of given instruction set alone in MB/s of UTF-32 for every encoding pair,
+// order: Latin-1 -> UTF-32, UTF-16 -> UTF-32 (BMP, astral), UTF-32 -> Latin-1, UTF-32 -> UTF-16 (BMP, astral)
+std::vector<double> Native(int rounds, int isa) {
+    using Clock = std::chrono::steady_clock;
+
+    if (isa < 0 || isa > Isa()) {
+        throw V8BindException("Instruction set isn't supported");
+    }
+    auto &kernel = kernels[isa];
+    std::vector<uint8_t> latin1(samples[0].size());
+    tc::Utf32ToLatin1(samples[0].data(), samples[0].size(), latin1.data());
+    std::vector<uint16_t> utf16[2];
+    for (int k = 0; k < 2; ++k) {
+        utf16[k].resize(samples[k + 1].size() * 2);
+        utf16[k].resize(tc::Utf32ToUtf16(samples[k + 1].data(), samples[k + 1].size(), utf16[k].data()));
+    }
+    std::u32string out(samples[0].size() * 2, U'\0');
+    std::vector<uint8_t> out8(samples[0].size());
+    std::vector<uint16_t> out16(samples[0].size() * 2);
+
+    auto measure = [rounds](size_t code_points, auto &&f) {
+        auto t0 = Clock::now();
+        for (int i = 0; i < rounds; ++i) {
+            f();
+        }
+        auto us = std::chrono::duration<double, std::micro>(Clock::now() - t0).count();
+        return 4.0 * code_points * rounds / us;
+    };
+    std::vector<double> result;
+    result.push_back(measure(latin1.size(),
+            [&] { kernel.latin1_to_utf32(latin1.data(), latin1.size(), out.data()); }));
+    for (int n = 0; n < 2; ++n) {
+        result.push_back(measure(samples[n + 1].size(),
+                [&] { kernel.utf16_to_utf32(utf16[n].data(), utf16[n].size(), out.data()); }));
+    }
+    result.push_back(measure(samples[0].size(),
+            [&] { kernel.utf32_to_latin1(samples[0].data(), samples[0].size(), out8.data()); }));
+    for (int n = 1; n < 3; ++n) {
+        result.push_back(measure(samples[n].size(),
+                [&] { kernel.utf32_to_utf16(samples[n].data(), samples[n].size(), out16.data()); }));
+    }
+    return result;
+}
+
+}
+
+NODE_MODULE_INIT() {
+    auto isolate = context->GetIsolate();
+
+    for (int i = 0; i < (1 << 20); ++i) {
+        samples[0] += char32_t(0x20 + i % 0xC0);
+        samples[1] += char32_t(0x400 + i % 0x400);
+        samples[2] += char32_t(i % 4 ? 0x61 : 0x1F600 + i % 64);
+    }
+
+    v8b::Module bindings(isolate);
+    bindings.Function("u32In", &U32In).Function("u32Out", &U32Out).Function("native", &Native)
+            .Function("isa", &Isa);
+    exports->Set(context, v8b::ToV8(isolate, "m"), bindings.NewInstance()).Check();
+}
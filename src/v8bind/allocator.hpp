@@ -0,0 +1,242 @@
+#ifndef SANDWICH_V8B_ALLOCATOR_HPP
+#define SANDWICH_V8B_ALLOCATOR_HPP
+
+#include <memory>
+#include <new>
+#include <type_traits>
+#include <utility>
+#include <vector>
+#include <cstddef>
+
+namespace v8b {
+
+namespace impl {
+
+// Deleter for memory allocated with operator new
+struct OperatorDelete {
+    void operator()(void *ptr) const {
+        ::operator delete(ptr);
+    }
+};
+
+} // namespace impl
+
+// Allocator with free list per size class (multiple of max_align_t alignment, 16 classes)
+// Larger blocks are passed to operator new
+// Memory is returned to system only when allocator is destroyed
+class SlabAllocator {
+public:
+    // Blocks of every size class are aligned as operator new result
+    static constexpr size_t granularity = alignof(std::max_align_t);
+    static constexpr size_t size_class_count = 16;
+    static constexpr size_t max_size = granularity * size_class_count;
+
+    SlabAllocator() = default;
+    SlabAllocator(const SlabAllocator &) = delete;
+    SlabAllocator &operator=(const SlabAllocator &) = delete;
+
+    void *Allocate(size_t size) {
+        if (size > max_size) {
+            return ::operator new(size);
+        }
+        auto &size_class = size_classes[SizeClassIndex(size)];
+        if (!size_class.free_list) {
+            Refill(size_class, (SizeClassIndex(size) + 1) * granularity);
+        }
+        auto block = size_class.free_list;
+        size_class.free_list = block->next;
+        return block;
+    }
+
+    // Size should be the same as passed to Allocate
+    void Deallocate(void *ptr, size_t size) {
+        if (size > max_size) {
+            ::operator delete(ptr);
+            return;
+        }
+        auto &size_class = size_classes[SizeClassIndex(size)];
+        auto block = static_cast<Block *>(ptr);
+        block->next = size_class.free_list;
+        size_class.free_list = block;
+    }
+
+private:
+    struct Block {
+        Block *next;
+    };
+
+    struct SizeClass {
+        Block *free_list = nullptr;
+        // Blocks per chunk, grows with each refill
+        size_t chunk_blocks = 16;
+    };
+
+    static constexpr size_t max_chunk_blocks = 1024;
+
+    SizeClass size_classes[size_class_count];
+    std::vector<std::unique_ptr<void, impl::OperatorDelete>> chunks;
+
+    static size_t SizeClassIndex(size_t size) {
+        return size ? (size - 1) / granularity : 0;
+    }
+
+    void Refill(SizeClass &size_class, size_t block_size) {
+        auto count = size_class.chunk_blocks;
+        auto memory = static_cast<char *>(::operator new(count * block_size));
+        chunks.emplace_back(memory);
+        for (size_t i = 0; i < count; ++i) {
+            auto block = reinterpret_cast<Block *>(memory + i * block_size);
+            block->next = i + 1 < count ? reinterpret_cast<Block *>(memory + (i + 1) * block_size) : nullptr;
+        }
+        size_class.free_list = reinterpret_cast<Block *>(memory);
+        if (size_class.chunk_blocks < max_chunk_blocks) {
+            size_class.chunk_blocks *= 2;
+        }
+    }
+};
+
+// Allocates memory sequentially from chunks, memory is freed only all at once
+class BumpArena {
+public:
+    static constexpr size_t alignment = alignof(std::max_align_t);
+
+    BumpArena() = default;
+    BumpArena(const BumpArena &) = delete;
+    BumpArena &operator=(const BumpArena &) = delete;
+
+    void *Allocate(size_t size) {
+        size = (size + alignment - 1) / alignment * alignment;
+        if (size > available) {
+            // Chunks grow geometrically, large blocks get chunk of their own
+            auto chunk_size = size > next_chunk_size ? size : next_chunk_size;
+            current = static_cast<char *>(::operator new(chunk_size));
+            chunks.emplace_back(current);
+            available = chunk_size;
+            if (next_chunk_size < max_chunk_size) {
+                next_chunk_size *= 2;
+            }
+        }
+        auto ptr = current;
+        current += size;
+        available -= size;
+        return ptr;
+    }
+
+private:
+    static constexpr size_t max_chunk_size = 1u << 20u;
+
+    std::vector<std::unique_ptr<void, impl::OperatorDelete>> chunks;
+    char *current = nullptr;
+    size_t available = 0;
+    size_t next_chunk_size = 4096;
+};
+
+// Objects placed in bump arena, destroyed in reverse order of creation with arena
+// Used for data bound to function templates and accessors, which live as long as isolate
+class BindingArena {
+public:
+    BindingArena() = default;
+    BindingArena(const BindingArena &) = delete;
+    BindingArena &operator=(const BindingArena &) = delete;
+
+    ~BindingArena() {
+        for (auto it = objects.rbegin(); it != objects.rend(); ++it) {
+            it->destroy(it->ptr);
+        }
+    }
+
+    template<typename T, typename ...Args>
+    T *New(Args&&... args) {
+        static_assert(alignof(T) <= BumpArena::alignment, "Over-aligned types aren't supported");
+        auto ptr = new (arena.Allocate(sizeof(T))) T(std::forward<Args>(args)...);
+        if constexpr (!std::is_trivially_destructible_v<T>) {
+            objects.push_back(Object { ptr, [](void *object) { static_cast<T *>(object)->~T(); } });
+        }
+        ++count;
+        return ptr;
+    }
+
+    [[nodiscard]]
+    bool Empty() const {
+        return count == 0;
+    }
+
+private:
+    struct Object {
+        void *ptr;
+        void (*destroy)(void *);
+    };
+
+    BumpArena arena;
+    std::vector<Object> objects;
+    size_t count = 0;
+};
+
+// Stack of scratch memory, released to position saved by Scope when it ends
+// Chunks are kept for reuse, so steady use doesn't allocate
+class ScratchStack {
+public:
+    static constexpr size_t alignment = alignof(std::max_align_t);
+
+    // Releases memory allocated while scope was active
+    class Scope {
+    public:
+        explicit Scope(ScratchStack &stack)
+            : stack(stack), chunk_index(stack.chunk_index), offset(stack.offset) {}
+
+        ~Scope() {
+            stack.chunk_index = chunk_index;
+            stack.offset = offset;
+        }
+
+        Scope(const Scope &) = delete;
+        Scope &operator=(const Scope &) = delete;
+
+    private:
+        ScratchStack &stack;
+        size_t chunk_index;
+        size_t offset;
+    };
+
+    ScratchStack() = default;
+    ScratchStack(const ScratchStack &) = delete;
+    ScratchStack &operator=(const ScratchStack &) = delete;
+
+    void *Allocate(size_t size) {
+        size = (size + alignment - 1) / alignment * alignment;
+        if (chunk_index < chunks.size() && size <= chunks[chunk_index].size - offset) {
+            auto ptr = chunks[chunk_index].memory.get() + offset;
+            offset += size;
+            return ptr;
+        }
+        // Next chunk is reused if it's large enough, else new one is inserted before it
+        auto next = chunks.empty() ? 0 : chunk_index + 1;
+        if (next == chunks.size() || chunks[next].size < size) {
+            auto chunk_size = size > next_chunk_size ? size : next_chunk_size;
+            chunks.insert(chunks.begin() + next, Chunk { std::unique_ptr<char[]>(new char[chunk_size]), chunk_size });
+            if (next_chunk_size < max_chunk_size) {
+                next_chunk_size *= 2;
+            }
+        }
+        chunk_index = next;
+        offset = size;
+        return chunks[next].memory.get();
+    }
+
+private:
+    struct Chunk {
+        std::unique_ptr<char[]> memory;
+        size_t size;
+    };
+
+    static constexpr size_t max_chunk_size = 1u << 20u;
+
+    std::vector<Chunk> chunks;
+    size_t chunk_index = 0;
+    size_t offset = 0;
+    size_t next_chunk_size = 4096;
+};
+
+}
+
+#endif //SANDWICH_V8B_ALLOCATOR_HPP
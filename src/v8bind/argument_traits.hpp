@@ -10,6 +10,9 @@
 #include <v8.h>
 
 #include <tuple>
+#include <optional>
+#include <utility>
+#include <type_traits>
 
 namespace v8b::traits {
 
@@ -88,6 +91,60 @@ struct ArgumentTraits<std::tuple<A1, A2, A...>> {
 template<typename T>
 using NonStrictArgumentTraits = ArgumentTraits<T, NonStrict>;
 
+// Arguments checked and converted in one pass with Convert<T>::TryFromV8
+// Converted values are kept on stack until call
+template<typename T>
+struct ConvertedArguments;
+
+template<typename ...A>
+struct ConvertedArguments<std::tuple<A...>> {
+    // Returns false if arguments count doesn't match or any argument can't be converted
+    template<typename R>
+    bool FromV8(const v8::FunctionCallbackInfo<R> &info) {
+        if (info.Length() != static_cast<int>(sizeof...(A))) {
+            return false;
+        }
+        if constexpr (uses_scratch) {
+            scratch.emplace(ClassManagerPool::GetScratch(info.GetIsolate()));
+        }
+        return FromV8Impl(info, std::index_sequence_for<A...> {});
+    }
+
+    template<size_t index>
+    decltype(auto) Get() {
+        auto &value = std::get<index>(values);
+        if constexpr (std::is_pointer_v<std::decay_t<decltype(value)>>) {
+            return *value;
+        } else {
+            return std::move(*value);
+        }
+    }
+
+private:
+    // Any non-primitive argument may put data in scratch memory (e.g. nested string views)
+    static constexpr bool uses_scratch = (!impl::IsScratchFree<A>::value || ...);
+
+    // Scratch memory used by arguments is released when call is done
+    std::conditional_t<uses_scratch, std::optional<ScratchStack::Scope>, std::nullptr_t> scratch {};
+    std::tuple<decltype(Convert<A>::TryFromV8(
+            std::declval<v8::Isolate *>(), std::declval<v8::Local<v8::Value>>()))...> values;
+
+    template<typename R, size_t ...Indices>
+    bool FromV8Impl(const v8::FunctionCallbackInfo<R> &info, std::index_sequence<Indices...>) {
+        return (static_cast<bool>(
+                std::get<Indices>(values) = Convert<A>::TryFromV8(info.GetIsolate(), info[Indices])) && ...);
+    }
+};
+
+// Functions with native v8 signature take info as is
+template<typename IR>
+struct ConvertedArguments<std::tuple<const v8::FunctionCallbackInfo<IR> &>> {
+    template<typename R>
+    bool FromV8(const v8::FunctionCallbackInfo<R> &) {
+        return std::is_same_v<IR, R>;
+    }
+};
+
 } //namespace v8b::traits
 
 #endif //SANDWICH_V8B_ARGUMENT_TRAITS_HPP
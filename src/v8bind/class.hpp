@@ -6,20 +6,24 @@
 #define SANDWICH_V8B_CLASS_HPP
 
 #include <v8bind/type_info.hpp>
+#include <v8bind/registry.hpp>
+#include <v8bind/allocator.hpp>
 
 #include <v8.h>
 
-#include <unordered_map>
 #include <type_traits>
 #include <memory>
 #include <vector>
 #include <cstddef>
 #include <tuple>
+#include <string>
 
 #define V8B_IMPL inline
 
 namespace v8b {
 
+class ObjectScope;
+
 class PointerManager {
     friend class ClassManager;
 
@@ -38,8 +42,10 @@ class ClassManager : public PointerManager {
 public:
     const TypeInfo type_info;
 
-    using ConstructorFunction = void * (*)(const v8::FunctionCallbackInfo<v8::Value> &);
+    // If memory isn't nullptr, object should be constructed in it
+    using ConstructorFunction = void * (*)(const v8::FunctionCallbackInfo<v8::Value> &, void *memory);
     using DestructorFunction = void (*)(v8::Isolate *, void *);
+    using AllocateFunction = void * (*)(v8::Isolate *);
 
     ClassManager(v8::Isolate *isolate, const TypeInfo &type_info);
     ~ClassManager();
@@ -57,19 +63,53 @@ public:
 
     v8::Local<v8::Object> FindObject(void *ptr) const;
     v8::Local<v8::Object> WrapObject(void *ptr, bool take_ownership);
+    // Array of wrappers for batch of objects (null for nullptr), already wrapped objects aren't
+    // wrapped again, missing ones are wrapped only if wrap_missing is set (else it throws)
+    // Context, template and registry capacity are resolved once per batch
+    v8::Local<v8::Array> WrapObjects(void *const *ptrs, size_t count,
+            PointerManager *pointer_manager, bool wrap_missing);
     v8::Local<v8::Object> WrapObject(void *ptr, PointerManager *pointer_manager);
     void SetPointerManager(void *ptr, PointerManager *pointer_manager);
 
+    // Object owned by std::shared_ptr, reference is kept in registry while wrapper is alive
+    v8::Local<v8::Object> WrapObject(void *ptr, std::shared_ptr<void> shared_ptr);
+    // Same as FindObject, but also stores reference if object is wrapped without it
+    v8::Local<v8::Object> FindObject(void *ptr, const std::shared_ptr<void> &shared_ptr);
+    // If wrapper owns object, ownership is moved to returned pointer (and registry keeps reference)
+    // Throws if object is owned by native code (wrapped without pointer manager)
+    std::shared_ptr<void> GetSharedPointer(void *ptr);
+
     void *UnwrapObject(v8::Local<v8::Value> value);
+    // Same as UnwrapObject, but returns nullptr instead of throwing
+    void *TryUnwrapObject(v8::Local<v8::Value> value);
 
+    // Template being configured, Vars aren't on it until InstallVars is called
     [[nodiscard]]
     v8::Local<v8::FunctionTemplate> GetFunctionTemplate() const;
 
-    void SetBase(const TypeInfo &type_info,
+    // Data member accessor, own property of every instance (see Class::Var)
+    void AddVar(v8::Local<v8::String> name, v8::AccessorGetterCallback getter,
+            v8::AccessorSetterCallback setter, v8::Local<v8::Value> data,
+            v8::PropertyAttribute attribute, v8::SideEffectType getter_side_effect_type);
+    // Puts Vars of class and its ancestors on instance template, so they're listed in declaration
+    // order (ancestors first), called when class is exposed (Class::GetFunctionTemplate)
+    // or its object is wrapped, Vars added later are listed first
+    void InstallVars();
+
+    void SetBase(ClassManager &base_class_manager,
             void *(*base_to_this)(void *), void *(*this_to_base)(void *));
 
     void SetConstructor(ConstructorFunction constructor_function);
     void SetDestructor(DestructorFunction destructor_function);
+    // Destructs object without freeing memory, required to place objects in ObjectScope arena
+    void SetInPlaceDestructor(DestructorFunction in_place_destructor_function);
+
+    // Custom allocation for objects created by JS constructor (see Class::Allocator)
+    // deallocate_function frees memory if constructor failed,
+    // destroy_function destructs object and frees its memory
+    // Pass nullptr to use operator new and destructor function again
+    void SetAllocator(AllocateFunction allocate_function,
+            DestructorFunction deallocate_function, DestructorFunction destroy_function);
 
     void SetAutoWrap(bool auto_wrap = true);
 
@@ -87,19 +127,72 @@ private:
         void *ptr;
         v8::Global<v8::Object> wrapped_object;
         PointerManager *pointer_manager;
+        // Manager which wrapped object (this or descendant)
+        ClassManager *class_manager;
+        std::shared_ptr<void> shared_ptr;
+        // Set if object is allocated with class allocator or in ObjectScope arena
+        DestructorFunction destroy_function;
+        bool in_arena;
     };
 
-    WrappedObject &FindWrappedObject(void *ptr, void **base_ptr_ptr = nullptr) const;
-    void ResetObject(WrappedObject &object);
-
-    std::unordered_map<void *, WrappedObject> objects;
+    v8::Local<v8::Object> WrapObjectImpl(void *ptr, PointerManager *pointer_manager,
+            std::shared_ptr<void> shared_ptr, DestructorFunction destroy_function = nullptr,
+            bool in_arena = false);
+    v8::Local<v8::Object> ConstructObject(const v8::FunctionCallbackInfo<v8::Value> &args);
+    void RegisterObject(v8::Local<v8::Object> wrapped, void *ptr, PointerManager *pointer_manager,
+            std::shared_ptr<void> shared_ptr, DestructorFunction destroy_function, bool in_arena);
+    // Prepare registry (and ancestors ones) for count new objects
+    void Reserve(size_t count);
+
+    friend class ObjectScope;
+
+    // Finds objects wrapped by this class or by its descendants (by pointer to this class)
+    WrappedObject &FindWrappedObject(void *ptr) const;
+    WrappedObject *TryFindWrappedObject(void *ptr) const;
+    // Set detach_wrapper to clear pointer stored in JS object, so it can't be unwrapped anymore
+    void ResetObject(WrappedObject &object, bool detach_wrapper);
+
+    // Cast pointer to object of this class to pointer of ancestor class
+    // Returns nullptr if ancestor isn't this class or one of its bases
+    void *CastToAncestor(const ClassManager *ancestor, void *ptr) const;
+    void UpdateAncestors();
+
+    // Make object wrapped by this class visible to ancestors by their pointer types
+    void RegisterInAncestors(WrappedObject &object);
+    void UnregisterFromAncestors(WrappedObject &object);
+
+    ObjectPool<WrappedObject> object_pool;
+    PointerTable<WrappedObject *> objects;
+    // Objects wrapped by descendants, keyed by pointer to this class
+    PointerTable<WrappedObject *> descendant_objects;
 
     v8::Isolate *isolate;
     v8::Persistent<v8::FunctionTemplate> function_template;
 
+    struct Var {
+        v8::Global<v8::String> name;
+        v8::AccessorGetterCallback getter;
+        v8::AccessorSetterCallback setter;
+        v8::Global<v8::Value> data;
+        v8::PropertyAttribute attribute;
+        v8::SideEffectType getter_side_effect_type;
+    };
+
+    // Kept after installation, descendants install them too
+    std::vector<Var> vars;
+    bool vars_installed = false;
+
+    void InstallVar(const Var &var);
+
     ConstructorFunction constructor_function;
     DestructorFunction destructor_function;
 
+    AllocateFunction allocate_function = nullptr;
+    DestructorFunction deallocate_function = nullptr;
+    DestructorFunction destroy_function = nullptr;
+
+    DestructorFunction in_place_destructor_function = nullptr;
+
     struct BaseClassInfo {
         ClassManager *base_class_manager = nullptr;
         void *(*base_to_this)(void *) = nullptr;
@@ -109,25 +202,218 @@ private:
     BaseClassInfo base_class_info;
     std::vector<ClassManager *> derived_class_managers;
 
+    struct AncestorInfo {
+        ClassManager *class_manager;
+        // Casts applied sequentially to get ancestor pointer from this pointer
+        std::vector<void *(*)(void *)> this_to_base;
+    };
+
+    // Root of hierarchy first, this class last, so ancestor
+    // is always found at index equal to its own depth
+    std::vector<AncestorInfo> ancestors;
+
     bool auto_wrap;
 };
 
+// Per-isolate fields of type converted by value, see ValueType
+class ValueTypeManager {
+public:
+    // Called with pointer to field itself
+    using FieldGetter = v8::Local<v8::Value> (*)(v8::Isolate *isolate, const void *field);
+    using FieldSetter = bool (*)(v8::Isolate *isolate, void *field, v8::Local<v8::Value> value);
+
+    explicit ValueTypeManager(v8::Isolate *isolate);
+
+    void AddField(const std::string &name, size_t offset, FieldGetter getter, FieldSetter setter);
+
+    // Creates plain object with values of all fields, throws V8BindException if it fails
+    v8::Local<v8::Object> ToV8(const void *object);
+    // Returns false if value isn't object or any field can't be converted
+    bool FromV8(v8::Local<v8::Value> value, void *object);
+
+private:
+    struct Field {
+        v8::Global<v8::String> name;
+        size_t offset;
+        FieldGetter getter;
+        FieldSetter setter;
+    };
+
+    v8::Isolate *isolate;
+    std::vector<Field> fields;
+    // Objects instantiated from one template share hidden class, reset when field is added
+    v8::Global<v8::ObjectTemplate> object_template;
+};
+
+// Isolate data slot where list of per-isolate ClassManagerPools is stored
+// Redefine if embedder already uses this slot
+// Pool has no state shared between isolates, so isolates can be used from different threads
+#if !defined(V8B_ISOLATE_DATA_SLOT)
+    #define V8B_ISOLATE_DATA_SLOT 3
+#endif
+
+namespace impl {
+
+// Slot is shared by all shared libraries using v8bind in process (e.g. several Node addons),
+// but type indices and pool layout are per library, so every library keeps own pool in list
+// keyed by address of library-local variable (layout of this struct must not change)
+struct IsolatePoolLink {
+    const void *key;
+    void *pool;
+    IsolatePoolLink *next;
+};
+
+} // namespace impl
+
 class ClassManagerPool {
 public:
     template<typename T>
     static ClassManager &Get(v8::Isolate *isolate);
 
     static ClassManager &Get(v8::Isolate *isolate, const TypeInfo &type_info);
+    // Destroy manager of one class, pool stays while it holds binding data or value types,
+    // because functions bound with them (e.g. module functions) may still be called from JS
     static void Remove(v8::Isolate *isolate, const TypeInfo &type_info);
+    // Destroy all managers and binding data of isolate, call before isolate is disposed
+    // Required once anything was bound, Remove alone never frees binding data
     static void RemoveAll(v8::Isolate *isolate);
+    // Returns nullptr if manager isn't created in isolate (or was removed)
+    static ClassManager *Find(v8::Isolate *isolate, size_t index);
+
+    // Per-isolate allocator for objects of classes with PoolAllocator
+    static SlabAllocator &GetAllocator(v8::Isolate *isolate);
+
+    // Per-isolate scratch memory for temporary data of native calls (e.g. string view arguments)
+    static ScratchStack &GetScratch(v8::Isolate *isolate);
+
+    // Per-isolate storage for data of bound functions and accessors (see ExternalData)
+    static BindingArena &GetBindings(v8::Isolate *isolate);
+
+    static ValueTypeManager &GetValueType(v8::Isolate *isolate, const TypeInfo &type_info);
+    // Returns nullptr if value type isn't registered in isolate
+    static ValueTypeManager *FindValueType(v8::Isolate *isolate, size_t index);
+
+    // %Object.prototype% of context, cached for the last used context
+    static v8::Local<v8::Value> GetObjectPrototype(v8::Isolate *isolate, v8::Local<v8::Context> context);
 
 private:
+    // Declared before managers, so it's destroyed after objects are released
+    SlabAllocator allocator;
+    ScratchStack scratch;
+    BindingArena bindings;
+    // Indexed by TypeInfo::GetIndex
     std::vector<std::unique_ptr<ClassManager>> managers;
+    std::vector<std::unique_ptr<ValueTypeManager>> value_types;
+    // Innermost active ObjectScope
+    ObjectScope *current_scope = nullptr;
+    // Weak, so cache doesn't keep context alive
+    v8::Global<v8::Context> prototype_context;
+    v8::Global<v8::Value> object_prototype;
+
+    friend class ObjectScope;
+    friend class ClassManager;
 
-    static std::unordered_map<v8::Isolate *, ClassManagerPool> pools;
-
+    // Returns nullptr if pool of this library isn't created in isolate
+    static ClassManagerPool *FindInstance(v8::Isolate *isolate);
     static ClassManagerPool &GetInstance(v8::Isolate *isolate);
     static void RemoveInstance(v8::Isolate *isolate);
+
+    // Same copy as TypeInfo indices have (one per library with hidden visibility)
+    inline static const char library_key = 0;
+    impl::IsolatePoolLink link { &library_key, this, nullptr };
+};
+
+namespace impl {
+
+// Values of these types are converted without scratch memory
+template<typename T, typename D = std::remove_cv_t<std::remove_reference_t<T>>>
+struct IsScratchFree : std::bool_constant<std::is_arithmetic_v<D> || std::is_enum_v<D>> {};
+
+// Releases scratch memory used while converting value of type T (including string views
+// nested in containers and value types), no-op for types that never use it
+template<typename T, bool = IsScratchFree<T>::value>
+class ScratchScope : ScratchStack::Scope {
+public:
+    explicit ScratchScope(v8::Isolate *isolate) : Scope(ClassManagerPool::GetScratch(isolate)) {}
+};
+
+template<typename T>
+class ScratchScope<T, true> {
+public:
+    explicit ScratchScope(v8::Isolate *) {}
+};
+
+} // namespace impl
+
+// Objects constructed from JS or wrapped while scope is active are bound to its lifetime
+// When scope is destroyed, they are detached from wrappers and released in reverse order,
+// objects created by JS constructors are placed in scope arena and their memory is freed at once
+// This applies to every object wrapped inside scope, not only to ones placed in arena:
+// wrapper returned or stored out of scope raises JS error on use (e.g. "Object is detached
+// from native instance"), objects owned by native code (wrapped without pointer manager)
+// are only detached, not destroyed
+// Scopes can be nested, objects are bound to the innermost one
+class ObjectScope {
+public:
+    explicit ObjectScope(v8::Isolate *isolate);
+    ~ObjectScope();
+
+    ObjectScope(const ObjectScope &) = delete;
+    ObjectScope &operator=(const ObjectScope &) = delete;
+
+private:
+    friend class ClassManager;
+
+    v8::Isolate *isolate;
+    ObjectScope *previous;
+    BumpArena arena;
+
+    struct ScopedObject {
+        // Index of class, manager may be removed before scope is closed
+        size_t type_index;
+        void *ptr;
+    };
+
+    std::vector<ScopedObject> objects;
+};
+
+// Allocation policy placing objects in per-isolate slab allocator, see Class::Allocator
+// Objects must not outlive isolate (including through std::shared_ptr)
+struct PoolAllocator {
+    static void *Allocate(v8::Isolate *isolate, size_t size);
+    static void Deallocate(v8::Isolate *isolate, void *ptr, size_t size);
+};
+
+// Specialize as std::true_type for types converted by value (see ValueType)
+template<typename T>
+struct IsValueType : std::false_type {};
+
+namespace impl {
+
+// Offset of data member of standard-layout class, same as offsetof
+// Measured on value-initialized local object, so T should be default constructible
+template<typename T, typename V>
+size_t MemberOffset(V T::*member) {
+    static_assert(std::is_standard_layout_v<T>, "Offset of member is defined only in standard-layout class");
+    T object {};
+    return static_cast<size_t>(reinterpret_cast<const char *>(std::addressof(object.*member))
+            - reinterpret_cast<const char *>(std::addressof(object)));
+}
+
+} // namespace impl
+
+// Converts T to and from plain JS objects with registered fields, copying values
+// No wrapper is created and nothing is tracked, all objects of type share one hidden class
+// IsValueType<T> must be specialized as std::true_type, fields are registered per isolate
+template<typename T>
+class ValueType {
+    ValueTypeManager &manager;
+
+public:
+    explicit ValueType(v8::Isolate *isolate);
+
+    template<typename V>
+    ValueType &Field(const std::string &name, V T::*member);
 };
 
 template<typename T>
@@ -145,6 +431,12 @@ public:
     template<typename ...Args>
     Class &Constructor();
 
+    // Set allocation policy for objects created by constructors set with Constructor<Args...>,
+    // objects created by factories or wrapped from C++ are still deleted with delete
+    // Policy should have static Allocate(isolate, size) and Deallocate(isolate, ptr, size)
+    template<typename Policy>
+    Class &Allocator();
+
     // Set factory functions
     template<typename ...F>
     Class &Constructor(F&&... f);
@@ -158,6 +450,9 @@ public:
     template<typename U>
     Class &Const(const std::string &name, U &&value);
 
+    // Data member, own property of every instance (unlike Property, accessor on prototype),
+    // so all Vars are listed by Object.keys and JSON.stringify in declaration order
+    // Members of primitive types in standard-layout classes share accessors (see impl::IsOffsetField)
     template<typename Member>
     Class &Var(const std::string &name, Member &&ptr);
 
@@ -187,55 +482,37 @@ public:
 
     Class &AutoWrap(bool auto_wrap = true);
 
+    // Installs Vars (see ClassManager::InstallVars), call when class is done
     [[nodiscard]]
     v8::Local<v8::FunctionTemplate> GetFunctionTemplate() const;
 
     static T *UnwrapObject(v8::Isolate *isolate, v8::Local<v8::Value> value);
+    static T *TryUnwrapObject(v8::Isolate *isolate, v8::Local<v8::Value> value);
     static v8::Local<v8::Object> WrapObject(v8::Isolate *isolate, T *ptr, bool take_ownership);
     static v8::Local<v8::Object> WrapObject(v8::Isolate *isolate, T *ptr, PointerManager *pointer_manager);
     static v8::Local<v8::Object> FindObject(v8::Isolate *isolate, T *ptr);
+    // Wrap many objects at once, already wrapped ones are reused
+    static v8::Local<v8::Array> WrapObjects(v8::Isolate *isolate, T *const *ptrs, size_t count,
+            bool take_ownership = false);
+    // Same as FindObject for many objects at once
+    static v8::Local<v8::Array> FindObjects(v8::Isolate *isolate, T *const *ptrs, size_t count);
     static void SetPointerManager(v8::Isolate *isolate, T *ptr, PointerManager *pointerManager);
 
 private:
     static bool initialized;
 };
 
+// Reference to object owned by std::shared_ptr is stored along with its registry entry
+// in per-isolate ClassManager, so there is no separate table of pointers
 template<typename T>
-class SharedPointerManager : public PointerManager {
-    std::unordered_map<T *, std::shared_ptr<T>> pointers;
-
+class SharedPointerManager {
 public:
-    V8B_IMPL static v8::Local<v8::Object> WrapObject(v8::Isolate *isolate, const std::shared_ptr<T> &ptr) {
-        auto &instance = PointerManager::GetInstance<SharedPointerManager>();
-        auto res = Class<T>::WrapObject(isolate, ptr.get(), &instance);
-        instance.pointers.emplace(ptr.get(), ptr);
-        return res;
-    }
-
-    V8B_IMPL static v8::Local<v8::Object> FindObject(v8::Isolate *isolate, const std::shared_ptr<T> &ptr) {
-        auto &instance = PointerManager::GetInstance<SharedPointerManager>();
-        auto object = Class<T>::FindObject(isolate, ptr.get());
-        if (instance.pointers.find(ptr.get()) == instance.pointers.end()) {
-            Class<T>::SetPointerManager(isolate, ptr.get(), &instance);
-            instance.pointers.emplace(ptr.get(), ptr);
-        }
-        return object;
-    }
-
-    V8B_IMPL static std::shared_ptr<T> UnwrapObject(v8::Isolate *isolate, v8::Local<v8::Value> value) {
-        auto &instance = PointerManager::GetInstance<SharedPointerManager>();
-        auto ptr = Class<T>::UnwrapObject(isolate, value);
-        if (instance.pointers.find(ptr) == instance.pointers.end()) {
-            Class<T>::SetPointerManager(isolate, ptr, &instance);
-            instance.pointers.emplace(ptr, std::shared_ptr<T>(ptr));
-        }
-        return instance.pointers.find(ptr)->second;
-    }
+    static v8::Local<v8::Object> WrapObject(v8::Isolate *isolate, const std::shared_ptr<T> &ptr);
+    static v8::Local<v8::Object> FindObject(v8::Isolate *isolate, const std::shared_ptr<T> &ptr);
+    static std::shared_ptr<T> UnwrapObject(v8::Isolate *isolate, v8::Local<v8::Value> value);
 
-protected:
-    V8B_IMPL void EndObjectManage(void *ptr) override {
-        pointers.erase(static_cast<T *>(ptr));
-    }
+    // Get shared pointer for already unwrapped object
+    static std::shared_ptr<T> GetSharedPointer(v8::Isolate *isolate, T *ptr);
 };
 
 }
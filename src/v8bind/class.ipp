@@ -28,13 +28,15 @@ V8B_IMPL ClassManager::ClassManager(v8::Isolate *isolate, const v8b::TypeInfo &t
         constructor_function(nullptr), destructor_function(nullptr) {
     v8::HandleScope scope(isolate);
 
+    ancestors.push_back(AncestorInfo { this, {} });
+
     auto f = v8::FunctionTemplate::New(isolate, [](const v8::FunctionCallbackInfo<v8::Value> &args) {
         auto self = ExternalData::Unwrap<ClassManager *>(args.Data());
         try {
             if (!self->constructor_function) {
                 throw V8BindException("No constructor specified");
             }
-            args.GetReturnValue().Set(self->WrapObject(self->constructor_function(args), true));
+            args.GetReturnValue().Set(self->ConstructObject(args));
         } catch (const V8BindException &e) {
             args.GetIsolate()->ThrowException(v8::Exception::Error(ToV8(args.GetIsolate(), std::string(e.what()))));
         }
@@ -49,57 +51,74 @@ V8B_IMPL ClassManager::ClassManager(v8::Isolate *isolate, const v8b::TypeInfo &t
 
 V8B_IMPL ClassManager::~ClassManager() {
     RemoveObjects();
+
+    // Unlink from hierarchy, so other managers don't refer to this one
+    if (auto base = base_class_info.base_class_manager) {
+        auto &siblings = base->derived_class_managers;
+        siblings.erase(std::remove(siblings.begin(), siblings.end(), this), siblings.end());
+    }
+    for (auto derived : derived_class_managers) {
+        derived->base_class_info = BaseClassInfo();
+        derived->UpdateAncestors();
+    }
 }
 
 V8B_IMPL void ClassManager::RemoveObject(void *ptr) {
-    auto it = objects.find(ptr);
-    if (it == objects.end()) {
+    auto object = objects.Find(ptr);
+    if (!object) {
         throw V8BindException("Can't remove unmanaged object");
     }
+    // Slot may be reused after erase, so keep entry pointer
+    auto wrapped_object = *object;
     v8::HandleScope scope(isolate);
-    ResetObject(it->second);
-    objects.erase(it);
+    ResetObject(*wrapped_object, true);
+    objects.Erase(ptr);
+    object_pool.Delete(wrapped_object);
 }
 
 V8B_IMPL void ClassManager::RemoveObjects() {
     v8::HandleScope scope(isolate);
-    for (auto &p : objects) {
-        ResetObject(p.second);
-    }
-    objects.clear();
+    // Take table, so destructors removing other objects don't modify it while iterating
+    auto removed = std::move(objects);
+    removed.ForEach([this](void *, WrappedObject *object) {
+        ResetObject(*object, true);
+        object_pool.Delete(object);
+    });
 }
 
-V8B_IMPL ClassManager::WrappedObject &ClassManager::FindWrappedObject(void *ptr, void **base_ptr_ptr) const {
-    // TODO
-    auto it = objects.find(ptr);
-    if (it == objects.end()) {
-        for (ClassManager *derived : derived_class_managers) {
-            try {
-                if (base_ptr_ptr) {
-                    auto &o = derived->FindWrappedObject(ptr, base_ptr_ptr);
-                    *base_ptr_ptr = derived->base_class_info.this_to_base(*base_ptr_ptr);
-                    return o;
-                } else {
-                    // Downcast only if ptr is base ptr, else return upcasted base_ptr in
-                    // base_ptr_ptr
-                    return derived->FindWrappedObject(derived->base_class_info.base_to_this(ptr));
-                }
-            } catch (const V8BindException &) {
-                continue;
-            }
-        }
+V8B_IMPL ClassManager::WrappedObject &ClassManager::FindWrappedObject(void *ptr) const {
+    auto wrapped_object = TryFindWrappedObject(ptr);
+    if (!wrapped_object) {
         throw V8BindException(std::string() + "Can't find wrapped object [" + type_info.GetName() + "]");
     }
-    if (base_ptr_ptr) {
-        *base_ptr_ptr = ptr;
+    return *wrapped_object;
+}
+
+V8B_IMPL ClassManager::WrappedObject *ClassManager::TryFindWrappedObject(void *ptr) const {
+    auto object = objects.Find(ptr);
+    if (object) {
+        return *object;
+    }
+    // Objects of derived classes are registered here on wrap,
+    // so no need to walk through derived managers
+    auto descendant_object = descendant_objects.Find(ptr);
+    if (descendant_object) {
+        return *descendant_object;
     }
-    return const_cast<WrappedObject &>(it->second);
+    return nullptr;
 }
 
-V8B_IMPL void ClassManager::ResetObject(WrappedObject &object) {
-    if (object.pointer_manager) {
+V8B_IMPL void ClassManager::ResetObject(WrappedObject &object, bool detach_wrapper) {
+    UnregisterFromAncestors(object);
+    if (detach_wrapper && !object.wrapped_object.IsEmpty()) {
+        object.wrapped_object.Get(isolate)->SetAlignedPointerInInternalField(0, nullptr);
+    }
+    if (object.destroy_function && object.pointer_manager == this) {
+        object.destroy_function(isolate, object.ptr);
+    } else if (object.pointer_manager) {
         object.pointer_manager->EndObjectManage(object.ptr);
     }
+    object.shared_ptr.reset();
     object.wrapped_object.Reset();
     isolate->AdjustAmountOfExternalAllocatedMemory(-static_cast<int64_t>(type_info.GetSize()));
 }
@@ -113,21 +132,23 @@ V8B_IMPL void ClassManager::SetPointerManager(void *ptr, PointerManager *pointer
         throw V8BindException("Can't set nullptr as pointer manager");
     }
 
-    auto it = objects.find(ptr);
-    if (it == objects.end()) {
-        try {
-            FindWrappedObject(ptr);
-        } catch (const V8BindException &) {
+    auto object = objects.Find(ptr);
+    if (!object) {
+        if (!TryFindWrappedObject(ptr)) {
             throw V8BindException("Can't find object");
         }
         throw V8BindException("Setting pointer manager for object through his base is not allowed");
     }
 
-    if (it->second.pointer_manager != nullptr && it->second.pointer_manager != this) {
+    if ((*object)->pointer_manager != nullptr && (*object)->pointer_manager != this) {
         throw V8BindException("Custom pointer manager already set");
     }
 
-    it->second.pointer_manager = pointer_manager;
+    if ((*object)->destroy_function) {
+        throw V8BindException("Can't set pointer manager for object allocated by class allocator");
+    }
+
+    (*object)->pointer_manager = pointer_manager;
 }
 
 V8B_IMPL v8::Local<v8::Object> ClassManager::WrapObject(void *ptr, bool take_ownership) {
@@ -135,27 +156,152 @@ V8B_IMPL v8::Local<v8::Object> ClassManager::WrapObject(void *ptr, bool take_own
 }
 
 V8B_IMPL v8::Local<v8::Object> ClassManager::WrapObject(void *ptr, PointerManager *pointer_manager) {
+    return WrapObjectImpl(ptr, pointer_manager, nullptr);
+}
+
+V8B_IMPL v8::Local<v8::Object> ClassManager::WrapObject(void *ptr, std::shared_ptr<void> shared_ptr) {
+    return WrapObjectImpl(ptr, nullptr, std::move(shared_ptr));
+}
+
+V8B_IMPL v8::Local<v8::Object> ClassManager::FindObject(void *ptr, const std::shared_ptr<void> &shared_ptr) {
+    auto &object = FindWrappedObject(ptr);
+    if (!object.shared_ptr) {
+        if (object.pointer_manager != nullptr && object.pointer_manager != object.class_manager) {
+            throw V8BindException("Custom pointer manager already set");
+        }
+        // Object is owned by shared pointer from now
+        object.pointer_manager = nullptr;
+        object.shared_ptr = shared_ptr;
+    }
+    return object.wrapped_object.Get(isolate);
+}
+
+V8B_IMPL std::shared_ptr<void> ClassManager::GetSharedPointer(void *ptr) {
+    auto &object = FindWrappedObject(ptr);
+    if (!object.shared_ptr) {
+        if (object.in_arena) {
+            throw V8BindException("Object placed in ObjectScope can't be shared");
+        }
+        // Object owned by native code, shared pointer can't keep it alive
+        if (object.pointer_manager == nullptr) {
+            throw V8BindException("Object isn't owned by JS and can't be shared");
+        }
+        if (object.pointer_manager != object.class_manager) {
+            throw V8BindException("Custom pointer manager already set");
+        }
+        // Don't capture manager, shared pointer may outlive it
+        auto owner = object.class_manager;
+        auto destructor_function = object.destroy_function ?
+                object.destroy_function : owner->destructor_function;
+        if (!destructor_function) {
+            throw V8BindException("No destructor specified");
+        }
+        object.shared_ptr = std::shared_ptr<void>(object.ptr,
+                [destructor_function, isolate = owner->isolate](void *ptr) {
+            destructor_function(isolate, ptr);
+        });
+        object.pointer_manager = nullptr;
+    }
+    return std::shared_ptr<void>(object.shared_ptr, ptr);
+}
+
+V8B_IMPL v8::Local<v8::Object> ClassManager::ConstructObject(const v8::FunctionCallbackInfo<v8::Value> &args) {
+    auto pool = ClassManagerPool::FindInstance(isolate);
+    if (pool->current_scope && in_place_destructor_function) {
+        // Memory isn't freed if constructor throws, arena can't do it anyway
+        void *memory = pool->current_scope->arena.Allocate(type_info.GetSize());
+        return WrapObjectImpl(constructor_function(args, memory), this, nullptr,
+                in_place_destructor_function, true);
+    }
+    if (!allocate_function) {
+        return WrapObject(constructor_function(args, nullptr), true);
+    }
+    void *memory = allocate_function(isolate);
+    void *ptr;
+    try {
+        ptr = constructor_function(args, memory);
+    } catch (...) {
+        deallocate_function(isolate, memory);
+        throw;
+    }
+    return WrapObjectImpl(ptr, this, nullptr, destroy_function);
+}
+
+V8B_IMPL v8::Local<v8::Object> ClassManager::WrapObjectImpl(void *ptr, PointerManager *pointer_manager,
+        std::shared_ptr<void> shared_ptr, DestructorFunction destroy_function, bool in_arena) {
     if (!ptr) {
         return v8::Local<v8::Object>();
     }
 
     v8::EscapableHandleScope scope(isolate);
 
-    bool found = false;
-    try {
-        FindWrappedObject(ptr);
-        found = true;
-    } catch (const V8BindException &) {
-        // Object not find, it's all ok
-    }
-    if (found) {
+    if (TryFindWrappedObject(ptr)) {
         throw V8BindException("Object is already wrapped");
     }
 
+    InstallVars();
     auto context = isolate->GetCurrentContext();
     auto wrapped = function_template.Get(isolate)
             ->InstanceTemplate()->NewInstance(context).ToLocalChecked();
 
+    RegisterObject(wrapped, ptr, pointer_manager, std::move(shared_ptr), destroy_function, in_arena);
+
+    isolate->AdjustAmountOfExternalAllocatedMemory(static_cast<int64_t>(type_info.GetSize()));
+
+    return scope.Escape(wrapped);
+}
+
+V8B_IMPL v8::Local<v8::Array> ClassManager::WrapObjects(void *const *ptrs, size_t count,
+        PointerManager *pointer_manager, bool wrap_missing) {
+    v8::EscapableHandleScope scope(isolate);
+
+    InstallVars();
+    auto context = isolate->GetCurrentContext();
+    auto instance_template = function_template.Get(isolate)->InstanceTemplate();
+
+    // Whole batch is checked and wrappers are created before anything is registered,
+    // so if it throws, registry is left untouched
+    std::vector<v8::Local<v8::Value>> elements(count);
+    std::vector<size_t> missing;
+    for (size_t i = 0; i < count; ++i) {
+        void *ptr = ptrs[i];
+        if (!ptr) {
+            elements[i] = v8::Null(isolate);
+            continue;
+        }
+        if (auto object = TryFindWrappedObject(ptr)) {
+            elements[i] = object->wrapped_object.Get(isolate);
+            continue;
+        }
+        if (!wrap_missing) {
+            throw V8BindException(std::string() + "Can't find wrapped object [" + type_info.GetName() + "]");
+        }
+        elements[i] = instance_template->NewInstance(context).ToLocalChecked();
+        missing.push_back(i);
+    }
+
+    Reserve(missing.size());
+
+    size_t wrapped_count = 0;
+    for (auto i : missing) {
+        // Same object may be passed more than once, then it's wrapped by its first occurrence
+        if (auto object = TryFindWrappedObject(ptrs[i])) {
+            elements[i] = object->wrapped_object.Get(isolate);
+            continue;
+        }
+        RegisterObject(elements[i].As<v8::Object>(), ptrs[i], pointer_manager, nullptr, nullptr, false);
+        ++wrapped_count;
+    }
+
+    isolate->AdjustAmountOfExternalAllocatedMemory(
+            static_cast<int64_t>(wrapped_count * type_info.GetSize()));
+
+    return scope.Escape(v8::Array::New(isolate, elements.data(), count));
+}
+
+V8B_IMPL void ClassManager::RegisterObject(v8::Local<v8::Object> wrapped, void *ptr,
+        PointerManager *pointer_manager, std::shared_ptr<void> shared_ptr,
+        DestructorFunction destroy_function, bool in_arena) {
     wrapped->SetAlignedPointerInInternalField(0, ptr);
     wrapped->SetAlignedPointerInInternalField(1, this);
 
@@ -163,24 +309,44 @@ V8B_IMPL v8::Local<v8::Object> ClassManager::WrapObject(void *ptr, PointerManage
     global.SetWeak(this, [](const v8::WeakCallbackInfo<ClassManager> &data) {
         void *ptr = data.GetInternalField(0);
         auto self = static_cast<ClassManager *>(data.GetInternalField(1));
-        self->RemoveObject(ptr);
+        auto object = self->objects.Find(ptr);
+        if (object) {
+            // Wrapper is being collected, so it's not detached
+            auto wrapped_object = *object;
+            self->ResetObject(*wrapped_object, false);
+            self->objects.Erase(ptr);
+            self->object_pool.Delete(wrapped_object);
+        }
     }, v8::WeakCallbackType::kInternalFields);
 
-    objects.emplace(ptr, WrappedObject {
+    auto object = object_pool.New(
         ptr,
         std::move(global),
-        pointer_manager
-    });
+        pointer_manager,
+        this,
+        std::move(shared_ptr),
+        destroy_function,
+        in_arena
+    );
+    objects.Insert(ptr, object);
 
-    isolate->AdjustAmountOfExternalAllocatedMemory(static_cast<int64_t>(type_info.GetSize()));
+    auto pool = ClassManagerPool::FindInstance(isolate);
+    if (pool && pool->current_scope) {
+        pool->current_scope->objects.push_back(ObjectScope::ScopedObject { type_info.GetIndex(), ptr });
+    }
 
-    return scope.Escape(wrapped);
+    RegisterInAncestors(*object);
 }
 
-V8B_IMPL void *ClassManager::UnwrapObject(v8::Local<v8::Value> value) {
-    v8::HandleScope scope(isolate);
+V8B_IMPL void ClassManager::Reserve(size_t count) {
+    objects.Reserve(count);
+    for (size_t i = 0; i + 1 < ancestors.size(); ++i) {
+        ancestors[i].class_manager->descendant_objects.Reserve(count);
+    }
+}
 
-    if (!value->IsObject()) {
+V8B_IMPL void *ClassManager::UnwrapObject(v8::Local<v8::Value> value) {
+    if (value.IsEmpty() || !value->IsObject()) {
         throw V8BindException("Can't unwrap - not an object");
     }
 
@@ -191,25 +357,156 @@ V8B_IMPL void *ClassManager::UnwrapObject(v8::Local<v8::Value> value) {
     }
 
     void *ptr = obj->GetAlignedPointerFromInternalField(0);
+    if (!ptr) {
+        throw V8BindException("Object is detached from native instance");
+    }
 
-    void *base_ptr = nullptr;
-    auto &wrapped_object = FindWrappedObject(ptr, &base_ptr);
+    auto owner = static_cast<ClassManager *>(obj->GetAlignedPointerFromInternalField(1));
+    void *base_ptr = owner ? owner->CastToAncestor(this, ptr) : nullptr;
+    if (!base_ptr) {
+        throw V8BindException(std::string() + "Can't unwrap object [" + type_info.GetName() + "]");
+    }
 
     return base_ptr;
 }
 
+V8B_IMPL void *ClassManager::TryUnwrapObject(v8::Local<v8::Value> value) {
+    if (value.IsEmpty() || !value->IsObject()) {
+        return nullptr;
+    }
+
+    auto obj = value.As<v8::Object>();
+
+    if (obj->InternalFieldCount() != 2) {
+        return nullptr;
+    }
+
+    // Pointer to ClassManager which wrapped object is stored in field 1,
+    // so no lookup needed, only cast to this class
+    void *ptr = obj->GetAlignedPointerFromInternalField(0);
+    auto owner = static_cast<ClassManager *>(obj->GetAlignedPointerFromInternalField(1));
+    if (!ptr || !owner) {
+        return nullptr;
+    }
+
+    return owner->CastToAncestor(this, ptr);
+}
+
+V8B_IMPL void *ClassManager::CastToAncestor(const ClassManager *ancestor, void *ptr) const {
+    auto depth = ancestor->ancestors.size() - 1;
+    if (depth >= ancestors.size() || ancestors[depth].class_manager != ancestor) {
+        return nullptr;
+    }
+    for (auto this_to_base : ancestors[depth].this_to_base) {
+        ptr = this_to_base(ptr);
+    }
+    return ptr;
+}
+
+V8B_IMPL void ClassManager::UpdateAncestors() {
+    // Objects are registered by pointers computed with old casts
+    objects.ForEach([this](void *, WrappedObject *object) {
+        UnregisterFromAncestors(*object);
+    });
+
+    ancestors.clear();
+    auto base = base_class_info.base_class_manager;
+    if (base) {
+        for (auto &base_ancestor : base->ancestors) {
+            AncestorInfo ancestor_info { base_ancestor.class_manager, { base_class_info.this_to_base } };
+            ancestor_info.this_to_base.insert(ancestor_info.this_to_base.end(),
+                    base_ancestor.this_to_base.begin(), base_ancestor.this_to_base.end());
+            ancestors.push_back(std::move(ancestor_info));
+        }
+    }
+    ancestors.push_back(AncestorInfo { this, {} });
+
+    objects.ForEach([this](void *, WrappedObject *object) {
+        RegisterInAncestors(*object);
+    });
+
+    for (auto derived : derived_class_managers) {
+        derived->UpdateAncestors();
+    }
+}
+
+V8B_IMPL void ClassManager::RegisterInAncestors(WrappedObject &object) {
+    for (size_t i = 0; i + 1 < ancestors.size(); ++i) {
+        ancestors[i].class_manager->descendant_objects.Insert(
+                CastToAncestor(ancestors[i].class_manager, object.ptr), &object);
+    }
+}
+
+V8B_IMPL void ClassManager::UnregisterFromAncestors(WrappedObject &object) {
+    for (size_t i = 0; i + 1 < ancestors.size(); ++i) {
+        auto &descendant_objects = ancestors[i].class_manager->descendant_objects;
+        auto ptr = CastToAncestor(ancestors[i].class_manager, object.ptr);
+        auto registered = descendant_objects.Find(ptr);
+        if (registered && *registered == &object) {
+            descendant_objects.Erase(ptr);
+        }
+    }
+}
+
 V8B_IMPL v8::Local<v8::FunctionTemplate> ClassManager::GetFunctionTemplate() const {
     return function_template.Get(isolate);
 }
 
-V8B_IMPL void ClassManager::SetBase(const v8b::TypeInfo &type_info,
+V8B_IMPL void ClassManager::AddVar(v8::Local<v8::String> name, v8::AccessorGetterCallback getter,
+        v8::AccessorSetterCallback setter, v8::Local<v8::Value> data,
+        v8::PropertyAttribute attribute, v8::SideEffectType getter_side_effect_type) {
+    vars.push_back(Var { v8::Global<v8::String>(isolate, name), getter, setter,
+            v8::Global<v8::Value>(isolate, data), attribute, getter_side_effect_type });
+    if (vars_installed) {
+        InstallVar(vars.back());
+    }
+}
+
+V8B_IMPL void ClassManager::InstallVars() {
+    if (vars_installed) {
+        return;
+    }
+    vars_installed = true;
+
+    // V8 creates accessors of template starting from the last one and skips names it already
+    // created (own template first, then ancestors), so all Vars are installed in reverse
+    v8::HandleScope scope(isolate);
+    for (auto ancestor = ancestors.rbegin(); ancestor != ancestors.rend(); ++ancestor) {
+        auto &ancestor_vars = ancestor->class_manager->vars;
+        for (auto var = ancestor_vars.rbegin(); var != ancestor_vars.rend(); ++var) {
+            InstallVar(*var);
+        }
+    }
+}
+
+V8B_IMPL void ClassManager::InstallVar(const Var &var) {
+    function_template.Get(isolate)->InstanceTemplate()->SetAccessor(
+            var.name.Get(isolate),
+            var.getter,
+            var.setter,
+            var.data.Get(isolate),
+            v8::AccessControl::DEFAULT,
+            var.attribute,
+#if V8_MAJOR_VERSION < 10
+            v8::Local<v8::AccessorSignature>(),
+#endif
+            var.getter_side_effect_type
+    );
+}
+
+V8B_IMPL void ClassManager::SetBase(ClassManager &base_class_manager,
         void *(*base_to_this)(void *), void *(*this_to_base)(void *)) {
+    if (auto base = base_class_info.base_class_manager) {
+        auto &siblings = base->derived_class_managers;
+        siblings.erase(std::remove(siblings.begin(), siblings.end(), this), siblings.end());
+    }
     base_class_info = BaseClassInfo {
-        &ClassManagerPool::Get(isolate, type_info),
+        &base_class_manager,
         base_to_this,
         this_to_base
     };
     base_class_info.base_class_manager->derived_class_managers.emplace_back(this);
+    UpdateAncestors();
     function_template.Get(isolate)->Inherit(
             base_class_info.base_class_manager->function_template.Get(
             base_class_info.base_class_manager->isolate));
@@ -223,6 +520,17 @@ V8B_IMPL void ClassManager::SetDestructor(DestructorFunction destructor_function
     this->destructor_function = destructor_function;
 }
 
+V8B_IMPL void ClassManager::SetInPlaceDestructor(DestructorFunction in_place_destructor_function) {
+    this->in_place_destructor_function = in_place_destructor_function;
+}
+
+V8B_IMPL void ClassManager::SetAllocator(AllocateFunction allocate_function,
+        DestructorFunction deallocate_function, DestructorFunction destroy_function) {
+    this->allocate_function = allocate_function;
+    this->deallocate_function = deallocate_function;
+    this->destroy_function = destroy_function;
+}
+
 V8B_IMPL void ClassManager::SetAutoWrap(bool auto_wrap) {
     this->auto_wrap = auto_wrap;
 }
@@ -243,37 +551,37 @@ V8B_IMPL void ClassManager::EndObjectManage(void *ptr) {
 
 template<typename T>
 V8B_IMPL ClassManager &ClassManagerPool::Get(v8::Isolate *isolate) {
-    static bool initialized = false;
-    if (!initialized) {
-        initialized = true;
-        DefaultBindings<T>::Initialize(isolate);
+    auto class_manager = Find(isolate, TypeInfo::GetIndexOf<T>());
+    if (class_manager) {
+        return *class_manager;
     }
-    return Get(isolate, TypeInfo::Get<T>());
+    auto &created = Get(isolate, TypeInfo::Get<T>());
+    DefaultBindings<T>::Initialize(isolate);
+    return created;
 }
 
 V8B_IMPL ClassManager &ClassManagerPool::Get(v8::Isolate *isolate, const TypeInfo &type_info) {
     auto &pool = GetInstance(isolate);
-    auto it = std::find_if(pool.managers.begin(), pool.managers.end(),
-            [&type_info](auto &class_manager) {
-        return class_manager->type_info == type_info;
-    });
-    if (it == pool.managers.end()) {
-        it = pool.managers.emplace(pool.managers.end(), new ClassManager(isolate, type_info));
+    auto index = type_info.GetIndex();
+    if (index >= pool.managers.size()) {
+        pool.managers.resize(index + 1);
     }
-    return *static_cast<ClassManager *>(it->get());
+    auto &class_manager = pool.managers[index];
+    if (!class_manager) {
+        class_manager.reset(new ClassManager(isolate, type_info));
+    }
+    return *class_manager;
 }
 
 V8B_IMPL void ClassManagerPool::Remove(v8::Isolate *isolate, const v8b::TypeInfo &type_info) {
-    auto &pool = GetInstance(isolate);
-    auto it = std::find_if(pool.managers.begin(), pool.managers.end(),
-            [&type_info](auto &class_manager) {
-        return class_manager->type_info == type_info;
-    });
-    if (it == pool.managers.end()) {
+    auto class_manager = Find(isolate, type_info.GetIndex());
+    if (!class_manager) {
         throw V8BindException("Can't find ClassManager instance to delete");
     }
-    pool.managers.erase(it);
-    if (pool.managers.empty()) {
+    auto &pool = GetInstance(isolate);
+    pool.managers[type_info.GetIndex()].reset();
+    if (pool.value_types.empty() && pool.bindings.Empty() && std::none_of(pool.managers.begin(), pool.managers.end(),
+            [](auto &class_manager) { return class_manager != nullptr; })) {
         RemoveInstance(isolate);
     }
 }
@@ -282,14 +590,215 @@ V8B_IMPL void ClassManagerPool::RemoveAll(v8::Isolate *isolate) {
     RemoveInstance(isolate);
 }
 
-V8B_IMPL std::unordered_map<v8::Isolate *, ClassManagerPool> ClassManagerPool::pools;
+V8B_IMPL ClassManager *ClassManagerPool::Find(v8::Isolate *isolate, size_t index) {
+    auto pool = ClassManagerPool::FindInstance(isolate);
+    if (!pool || index >= pool->managers.size()) {
+        return nullptr;
+    }
+    return pool->managers[index].get();
+}
+
+V8B_IMPL ClassManagerPool *ClassManagerPool::FindInstance(v8::Isolate *isolate) {
+    auto link = static_cast<impl::IsolatePoolLink *>(isolate->GetData(V8B_ISOLATE_DATA_SLOT));
+    while (link && link->key != &library_key) {
+        link = link->next;
+    }
+    return link ? static_cast<ClassManagerPool *>(link->pool) : nullptr;
+}
 
 V8B_IMPL ClassManagerPool &ClassManagerPool::GetInstance(v8::Isolate *isolate) {
-    return pools[isolate];
+    auto pool = FindInstance(isolate);
+    if (!pool) {
+        pool = new ClassManagerPool();
+        pool->link.next = static_cast<impl::IsolatePoolLink *>(isolate->GetData(V8B_ISOLATE_DATA_SLOT));
+        isolate->SetData(V8B_ISOLATE_DATA_SLOT, &pool->link);
+    }
+    return *pool;
 }
 
 V8B_IMPL void ClassManagerPool::RemoveInstance(v8::Isolate *isolate) {
-    pools.erase(isolate);
+    auto pool = FindInstance(isolate);
+    if (!pool) {
+        return;
+    }
+    // Released objects may return memory to pool allocator, so pool should be reachable
+    pool->managers.clear();
+    // Pools of other libraries stay in list
+    auto head = static_cast<impl::IsolatePoolLink *>(isolate->GetData(V8B_ISOLATE_DATA_SLOT));
+    if (head == &pool->link) {
+        isolate->SetData(V8B_ISOLATE_DATA_SLOT, pool->link.next);
+    } else {
+        auto link = head;
+        while (link->next != &pool->link) {
+            link = link->next;
+        }
+        link->next = pool->link.next;
+    }
+    delete pool;
+}
+
+V8B_IMPL SlabAllocator &ClassManagerPool::GetAllocator(v8::Isolate *isolate) {
+    return GetInstance(isolate).allocator;
+}
+
+V8B_IMPL ScratchStack &ClassManagerPool::GetScratch(v8::Isolate *isolate) {
+    return GetInstance(isolate).scratch;
+}
+
+V8B_IMPL BindingArena &ClassManagerPool::GetBindings(v8::Isolate *isolate) {
+    return GetInstance(isolate).bindings;
+}
+
+V8B_IMPL v8::Local<v8::Value> ClassManagerPool::GetObjectPrototype(v8::Isolate *isolate,
+                                                                  v8::Local<v8::Context> context) {
+    auto &pool = GetInstance(isolate);
+    // Handles are cleared together when context is collected
+    if (pool.prototype_context.IsEmpty() || pool.prototype_context != context) {
+        v8::Context::Scope context_scope(context);
+        pool.object_prototype.Reset(isolate, v8::Object::New(isolate)->GetPrototype());
+        pool.object_prototype.SetWeak();
+        pool.prototype_context.Reset(isolate, context);
+        pool.prototype_context.SetWeak();
+    }
+    return pool.object_prototype.Get(isolate);
+}
+
+V8B_IMPL ValueTypeManager &ClassManagerPool::GetValueType(v8::Isolate *isolate, const TypeInfo &type_info) {
+    auto &pool = GetInstance(isolate);
+    auto index = type_info.GetIndex();
+    if (index >= pool.value_types.size()) {
+        pool.value_types.resize(index + 1);
+    }
+    auto &manager = pool.value_types[index];
+    if (!manager) {
+        manager.reset(new ValueTypeManager(isolate));
+    }
+    return *manager;
+}
+
+V8B_IMPL ValueTypeManager *ClassManagerPool::FindValueType(v8::Isolate *isolate, size_t index) {
+    auto pool = ClassManagerPool::FindInstance(isolate);
+    if (!pool || index >= pool->value_types.size()) {
+        return nullptr;
+    }
+    return pool->value_types[index].get();
+}
+
+V8B_IMPL ValueTypeManager::ValueTypeManager(v8::Isolate *isolate) : isolate(isolate) {}
+
+V8B_IMPL void ValueTypeManager::AddField(const std::string &name, size_t offset,
+        FieldGetter getter, FieldSetter setter) {
+    v8::HandleScope scope(isolate);
+    fields.push_back(Field { v8::Global<v8::String>(isolate, v8b::ToV8(isolate, name)), offset, getter, setter });
+    object_template.Reset();
+}
+
+V8B_IMPL v8::Local<v8::Object> ValueTypeManager::ToV8(const void *object) {
+    v8::EscapableHandleScope scope(isolate);
+    auto context = isolate->GetCurrentContext();
+
+    if (object_template.IsEmpty()) {
+        auto new_template = v8::ObjectTemplate::New(isolate);
+        for (auto &field : fields) {
+            new_template->Set(field.name.Get(isolate), v8::Undefined(isolate));
+        }
+        object_template.Reset(isolate, new_template);
+    }
+
+    v8::Local<v8::Object> result;
+    if (!object_template.Get(isolate)->NewInstance(context).ToLocal(&result)) {
+        throw V8BindException("Can't create object of value type");
+    }
+    auto base = static_cast<const char *>(object);
+    for (auto &field : fields) {
+        auto value = field.getter(isolate, base + field.offset);
+        if (value.IsEmpty()) {
+            value = v8::Undefined(isolate);
+        }
+        // Defined as own data property, so setters on prototype aren't called
+        if (!result->CreateDataProperty(context, field.name.Get(isolate), value).FromMaybe(false)) {
+            throw V8BindException("Can't set field of value type object");
+        }
+    }
+    return scope.Escape(result);
+}
+
+V8B_IMPL bool ValueTypeManager::FromV8(v8::Local<v8::Value> value, void *object) {
+    if (value.IsEmpty() || !value->IsObject()) {
+        return false;
+    }
+    v8::HandleScope scope(isolate);
+    auto context = isolate->GetCurrentContext();
+    auto source = value.As<v8::Object>();
+    auto base = static_cast<char *>(object);
+    for (auto &field : fields) {
+        v8::Local<v8::Value> field_value;
+        if (!source->Get(context, field.name.Get(isolate)).ToLocal(&field_value)
+                || !field.setter(isolate, base + field.offset, field_value)) {
+            return false;
+        }
+    }
+    return true;
+}
+
+template<typename T>
+V8B_IMPL ValueType<T>::ValueType(v8::Isolate *isolate)
+        : manager(ClassManagerPool::GetValueType(isolate, TypeInfo::Get<T>())) {
+    static_assert(IsValueType<T>::value, "IsValueType<T> must be specialized as std::true_type");
+}
+
+template<typename T>
+template<typename V>
+V8B_IMPL ValueType<T> &ValueType<T>::Field(const std::string &name, V T::*member) {
+    manager.AddField(name, impl::MemberOffset(member),
+        [](v8::Isolate *isolate, const void *field) -> v8::Local<v8::Value> {
+            return Convert<V>::ToV8(isolate, *static_cast<const V *>(field));
+        },
+        [](v8::Isolate *isolate, void *field, v8::Local<v8::Value> value) {
+            auto converted = Convert<V>::TryFromV8(isolate, value);
+            if (!converted) {
+                return false;
+            }
+            // Wrapped objects are returned by pointer and copied
+            if constexpr (std::is_pointer_v<decltype(converted)>) {
+                *static_cast<V *>(field) = *converted;
+            } else {
+                *static_cast<V *>(field) = std::move(*converted);
+            }
+            return true;
+        });
+    return *this;
+}
+
+V8B_IMPL ObjectScope::ObjectScope(v8::Isolate *isolate) : isolate(isolate) {
+    auto &pool = ClassManagerPool::GetInstance(isolate);
+    previous = pool.current_scope;
+    pool.current_scope = this;
+}
+
+V8B_IMPL ObjectScope::~ObjectScope() {
+    auto pool = ClassManagerPool::FindInstance(isolate);
+    if (!pool) {
+        // Isolate was torn down, objects are already released
+        return;
+    }
+    pool->current_scope = previous;
+
+    for (auto it = objects.rbegin(); it != objects.rend(); ++it) {
+        auto class_manager = ClassManagerPool::Find(isolate, it->type_index);
+        // Object may be already collected, then there is nothing to release
+        if (class_manager && class_manager->objects.Find(it->ptr)) {
+            class_manager->RemoveObject(it->ptr);
+        }
+    }
+}
+
+V8B_IMPL void *PoolAllocator::Allocate(v8::Isolate *isolate, size_t size) {
+    return ClassManagerPool::GetAllocator(isolate).Allocate(size);
+}
+
+V8B_IMPL void PoolAllocator::Deallocate(v8::Isolate *isolate, void *ptr, size_t size) {
+    ClassManagerPool::GetAllocator(isolate).Deallocate(ptr, size);
 }
 
 
@@ -301,6 +810,11 @@ V8B_IMPL Class<T>::Class(v8::Isolate *isolate)
         auto obj = static_cast<T *>(ptr);
         delete obj;
     });
+    if constexpr (alignof(T) <= BumpArena::alignment) {
+        class_manager.SetInPlaceDestructor([](v8::Isolate *isolate, void *ptr) {
+            static_cast<T *>(ptr)->~T();
+        });
+    }
 }
 
 template<typename T>
@@ -308,7 +822,8 @@ template<typename B>
 V8B_IMPL Class<T> &Class<T>::Inherit() {
     static_assert(std::is_base_of_v<B, T>,
             "Class B should be base for class T");
-    class_manager.SetBase(TypeInfo::Get<B>(),
+    // Get manager through template, so default bindings of B are initialized
+    class_manager.SetBase(ClassManagerPool::Get<B>(class_manager.GetIsolate()),
             [](void *base_ptr) -> void * {
                 return static_cast<void *>(static_cast<T *>(static_cast<B *>(base_ptr)));
             },
@@ -322,16 +837,36 @@ V8B_IMPL Class<T> &Class<T>::Inherit() {
 template<typename T>
 template<typename ...Args>
 V8B_IMPL Class<T> &Class<T>::Constructor() {
-    class_manager.SetConstructor([](const v8::FunctionCallbackInfo<v8::Value> &args) -> void * {
-        return CallConstructor<T, Args...>(args);
+    class_manager.SetConstructor([](const v8::FunctionCallbackInfo<v8::Value> &args, void *memory) -> void * {
+        return CallConstructor<T, Args...>(args, memory);
     });
     return *this;
 }
 
+template<typename T>
+template<typename Policy>
+V8B_IMPL Class<T> &Class<T>::Allocator() {
+    static_assert(alignof(T) <= alignof(std::max_align_t),
+            "Over-aligned classes can't use custom allocation");
+    class_manager.SetAllocator(
+            [](v8::Isolate *isolate) -> void * {
+                return Policy::Allocate(isolate, sizeof(T));
+            },
+            [](v8::Isolate *isolate, void *ptr) {
+                Policy::Deallocate(isolate, ptr, sizeof(T));
+            },
+            [](v8::Isolate *isolate, void *ptr) {
+                static_cast<T *>(ptr)->~T();
+                Policy::Deallocate(isolate, ptr, sizeof(T));
+            }
+    );
+    return *this;
+}
+
 template<typename T>
 template<typename ...F>
 V8B_IMPL Class<T> &Class<T>::Constructor(F&&... f) {
-    WrapConstructor(class_manager.GetIsolate(), std::forward<F>(f)..., class_manager.GetFunctionTemplate());
+    WrapConstructor<F...>(class_manager.GetIsolate(), std::forward<F>(f)..., class_manager.GetFunctionTemplate());
     return *this;
 }
 
@@ -365,18 +900,19 @@ V8B_IMPL Class<T> &Class<T>::Const(const std::string &name, U &&value) {
 template<typename T>
 template<typename Member>
 V8B_IMPL Class<T> &Class<T>::Var(const std::string &name, Member &&ptr) {
-    v8::HandleScope scope(class_manager.GetIsolate());
-
-    auto data = impl::VarAccessor<true>(class_manager.GetIsolate(), std::forward<Member>(ptr));
+    auto isolate = class_manager.GetIsolate();
+    v8::HandleScope scope(isolate);
 
-    class_manager.GetFunctionTemplate()->PrototypeTemplate()->SetAccessor(
-            ToV8(class_manager.GetIsolate(), name),
-            data.getter,
-            data.setter,
-            data.data,
-            v8::AccessControl::DEFAULT,
-            data.attribute
-    );
+    if constexpr (impl::IsOffsetField<std::decay_t<Member>>::value) {
+        // Getter only reads memory
+        auto data = impl::FieldAccessor(isolate, ptr);
+        class_manager.AddVar(ToV8(isolate, name), data.getter, data.setter, data.data, data.attribute,
+                v8::SideEffectType::kHasNoSideEffect);
+    } else {
+        auto data = impl::VarAccessor<true>(isolate, std::forward<Member>(ptr));
+        class_manager.AddVar(ToV8(isolate, name), data.getter, data.setter, data.data, data.attribute,
+                v8::SideEffectType::kHasSideEffect);
+    }
 
     return *this;
 }
@@ -425,7 +961,7 @@ V8B_IMPL Class<T> &Class<T>::Indexer(Getter &&get, Setter &&set) {
         try {
             auto obj = UnwrapObject(info.GetIsolate(), info.This());
             decltype(auto) acc = ExternalData::Unwrap<decltype(accessors)>(info.Data());
-            info.GetReturnValue().Set(ToV8(info.GetIsolate(), std::invoke(std::get<0>(acc), *obj, index)));
+            impl::SetReturnValue(info.GetReturnValue(), info.GetIsolate(), std::invoke(std::get<0>(acc), *obj, index));
         } catch (const V8BindException &e) {
             info.GetIsolate()->ThrowException(v8::Exception::Error(ToV8(info.GetIsolate(), std::string(e.what()))));
         }
@@ -436,6 +972,8 @@ V8B_IMPL Class<T> &Class<T>::Indexer(Getter &&get, Setter &&set) {
         setter = [](uint32_t index, v8::Local<v8::Value> value,
             const v8::PropertyCallbackInfo<v8::Value> &info) {
             try {
+                impl::ScratchScope<std::tuple_element_t<2, typename SetterTrait::arguments>>
+                        scratch(info.GetIsolate());
                 auto obj = UnwrapObject(info.GetIsolate(), info.This());
                 decltype(auto) acc = ExternalData::Unwrap<decltype(accessors)>(info.Data());
                 std::invoke(std::get<1>(acc), *obj, index,
@@ -549,6 +1087,7 @@ V8B_IMPL Class<T> &Class<T>::AutoWrap(bool auto_wrap) {
 
 template<typename T>
 V8B_IMPL v8::Local<v8::FunctionTemplate> Class<T>::GetFunctionTemplate() const {
+    class_manager.InstallVars();
     return class_manager.GetFunctionTemplate();
 }
 
@@ -557,6 +1096,11 @@ V8B_IMPL T *Class<T>::UnwrapObject(v8::Isolate *isolate, v8::Local<v8::Value> va
     return static_cast<T *>(ClassManagerPool::Get<T>(isolate).UnwrapObject(value));
 }
 
+template<typename T>
+V8B_IMPL T *Class<T>::TryUnwrapObject(v8::Isolate *isolate, v8::Local<v8::Value> value) {
+    return static_cast<T *>(ClassManagerPool::Get<T>(isolate).TryUnwrapObject(value));
+}
+
 template<typename T>
 V8B_IMPL v8::Local<v8::Object> Class<T>::WrapObject(v8::Isolate *isolate, T *ptr, bool take_ownership) {
     return ClassManagerPool::Get<T>(isolate).WrapObject(ptr, take_ownership);
@@ -567,6 +1111,21 @@ V8B_IMPL v8::Local<v8::Object> Class<T>::WrapObject(v8::Isolate *isolate, T *ptr
     return ClassManagerPool::Get<T>(isolate).WrapObject(ptr, pointer_manager);
 }
 
+template<typename T>
+V8B_IMPL v8::Local<v8::Array> Class<T>::WrapObjects(v8::Isolate *isolate, T *const *ptrs, size_t count,
+        bool take_ownership) {
+    auto &class_manager = ClassManagerPool::Get<T>(isolate);
+    return class_manager.WrapObjects(reinterpret_cast<void *const *>(ptrs), count,
+            take_ownership ? &class_manager : nullptr, true);
+}
+
+template<typename T>
+V8B_IMPL v8::Local<v8::Array> Class<T>::FindObjects(v8::Isolate *isolate, T *const *ptrs, size_t count) {
+    auto &class_manager = ClassManagerPool::Get<T>(isolate);
+    return class_manager.WrapObjects(reinterpret_cast<void *const *>(ptrs), count,
+            nullptr, class_manager.IsAutoWrapEnabled());
+}
+
 template<typename T>
 V8B_IMPL void Class<T>::SetPointerManager(v8::Isolate *isolate, T *ptr, PointerManager *pointer_manager) {
     ClassManagerPool::Get<T>(isolate).SetPointerManager(ptr, pointer_manager);
@@ -586,6 +1145,38 @@ V8B_IMPL v8::Local<v8::Object> Class<T>::FindObject(v8::Isolate *isolate, T *ptr
 }
 
 
+template<typename T>
+V8B_IMPL v8::Local<v8::Object> SharedPointerManager<T>::WrapObject(v8::Isolate *isolate,
+        const std::shared_ptr<T> &ptr) {
+    return ClassManagerPool::Get<T>(isolate).WrapObject(ptr.get(), ptr);
+}
+
+template<typename T>
+V8B_IMPL v8::Local<v8::Object> SharedPointerManager<T>::FindObject(v8::Isolate *isolate,
+        const std::shared_ptr<T> &ptr) {
+    auto &class_manager = ClassManagerPool::Get<T>(isolate);
+    try {
+        return class_manager.FindObject(ptr.get(), ptr);
+    } catch (const V8BindException &e) {
+        if (!class_manager.IsAutoWrapEnabled()) {
+            throw e;
+        }
+        return class_manager.WrapObject(ptr.get(), ptr);
+    }
+}
+
+template<typename T>
+V8B_IMPL std::shared_ptr<T> SharedPointerManager<T>::UnwrapObject(v8::Isolate *isolate,
+        v8::Local<v8::Value> value) {
+    return GetSharedPointer(isolate, Class<T>::UnwrapObject(isolate, value));
+}
+
+template<typename T>
+V8B_IMPL std::shared_ptr<T> SharedPointerManager<T>::GetSharedPointer(v8::Isolate *isolate, T *ptr) {
+    // Aliasing constructor, pointer in registry may point to derived object
+    return std::shared_ptr<T>(ClassManagerPool::Get<T>(isolate).GetSharedPointer(ptr), ptr);
+}
+
 }
 
 #endif //SANDWICH_V8B_CLASS_IPP
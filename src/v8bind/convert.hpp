@@ -8,6 +8,8 @@
 #include <v8bind/class.hpp>
 #include <v8bind/traits.hpp>
 #include <v8bind/exception.hpp>
+#include <v8bind/transcode.hpp>
+#include <v8bind/span.hpp>
 
 #include <v8.h>
 
@@ -17,15 +19,38 @@
 #include <stdexcept>
 #include <exception>
 #include <memory>
-#include <locale>
-#include <codecvt>
 #include <map>
+#include <unordered_map>
+#include <deque>
+#include <list>
+#include <array>
+#include <iterator>
+#include <new>
+#include <optional>
+#include <cmath>
+#include <limits>
+#include <cstring>
+#include <cstdint>
+#include <charconv>
 
 namespace v8b {
 
+// Every Convert specialization provides:
+//  - IsValid(isolate, value) to check if value can be converted
+//  - TryFromV8(isolate, value) to check and convert value in one pass,
+//    returns std::optional with converted value (or raw pointer for
+//    references to wrapped objects), empty if value can't be converted
+//  - FromV8(isolate, value) to convert value, throws if value can't be converted
+//  - ToV8(isolate, value) to convert C++ value to V8
+// Optionally:
+//  - SetReturnValue(return_value, isolate, value) to store value as callback result
+//    without creating a handle (primitives are written to ReturnValue directly)
 template<typename T, typename Enable = void>
 struct Convert;
 
+template<typename T>
+struct IsWrappedClass;
+
 template<typename T>
 struct Convert<v8::Local<T>> {
     using CType = v8::Local<T>;
@@ -35,6 +60,13 @@ struct Convert<v8::Local<T>> {
         return !value.As<T>().IsEmpty();
     }
 
+    static std::optional<CType> TryFromV8(v8::Isolate *isolate, v8::Local<v8::Value> value) {
+        if (!IsValid(isolate, value)) {
+            return std::nullopt;
+        }
+        return value.As<T>();
+    }
+
     static CType FromV8(v8::Isolate *isolate, v8::Local<v8::Value> value) {
         if (!IsValid(isolate, value)) {
             throw V8BindException("Value is not of type");
@@ -56,6 +88,13 @@ struct Convert<bool> {
         return !value.IsEmpty() && value->IsBoolean();
     }
 
+    static std::optional<CType> TryFromV8(v8::Isolate *isolate, v8::Local<v8::Value> value) {
+        if (!IsValid(isolate, value)) {
+            return std::nullopt;
+        }
+        return value.As<v8::Boolean>()->Value();
+    }
+
     static CType FromV8(v8::Isolate *isolate, v8::Local<v8::Value> value) {
         if (!IsValid(isolate, value)) {
             throw V8BindException("Value is not a valid bool");
@@ -66,10 +105,15 @@ struct Convert<bool> {
     static V8Type ToV8(v8::Isolate *isolate, CType value) {
         return v8::Boolean::New(isolate, value);
     }
+
+    template<typename R>
+    static void SetReturnValue(v8::ReturnValue<R> return_value, v8::Isolate *, CType value) {
+        return_value.Set(value);
+    }
 };
 
 template<typename T>
-struct Convert<T, std::enable_if_t<std::is_floating_point_v<T> || std::is_integral_v<T>>> {
+struct Convert<T, std::enable_if_t<std::is_floating_point_v<T>>> {
     using CType = T;
     using V8Type = v8::Local<v8::Number>;
 
@@ -77,6 +121,13 @@ struct Convert<T, std::enable_if_t<std::is_floating_point_v<T> || std::is_integr
         return !value.IsEmpty() && value->IsNumber();
     }
 
+    static std::optional<CType> TryFromV8(v8::Isolate *isolate, v8::Local<v8::Value> value) {
+        if (!IsValid(isolate, value)) {
+            return std::nullopt;
+        }
+        return static_cast<T>(value.As<v8::Number>()->Value());
+    }
+
     static CType FromV8(v8::Isolate *isolate, v8::Local<v8::Value> value) {
         if (!IsValid(isolate, value)) {
             throw V8BindException("Value is not a valid number");
@@ -87,6 +138,213 @@ struct Convert<T, std::enable_if_t<std::is_floating_point_v<T> || std::is_integr
     static V8Type ToV8(v8::Isolate *isolate, CType value) {
         return v8::Number::New(isolate, static_cast<double>(value));
     }
+
+    // ReturnValue::Set(double) creates a handle, so integral values are stored as int32
+    // Range is checked in double, INT32_MAX converted to float rounds up to 2^31
+    template<typename R>
+    static void SetReturnValue(v8::ReturnValue<R> return_value, v8::Isolate *, CType value) {
+        auto number = static_cast<double>(value);
+        if (number >= -2147483648.0 && number < 2147483648.0) {
+            auto i = static_cast<int32_t>(number);
+            if (i == number && (i != 0 || !std::signbit(number))) {
+                return_value.Set(i);
+                return;
+            }
+        }
+        return_value.Set(number);
+    }
+};
+
+// 64-bit integers are converted to BigInt instead of Number, so they don't lose precision
+// BigInt is accepted as argument in any case
+#if !defined(V8B_INT64_AS_BIGINT)
+    #define V8B_INT64_AS_BIGINT 0
+#endif
+
+namespace impl {
+
+// Returns nullopt if number isn't integral or is out of range of T (NaN and infinities too),
+// so it's never truncated or wrapped
+template<typename T>
+std::optional<T> IntegralFromNumber(double number) {
+    // 2^digits, exact in double unlike max() of 64-bit types
+    constexpr double upper = static_cast<double>(std::numeric_limits<T>::max() / 2 + 1) * 2.0;
+    constexpr double lower = std::is_signed_v<T> ? -upper : 0.0;
+    if (!(number >= lower && number < upper) || std::trunc(number) != number) {
+        return std::nullopt;
+    }
+    return static_cast<T>(number);
+}
+
+} // namespace impl
+
+// Integers up to 32 bits are created with v8::Integer, so they are Smis when fit
+// Numbers holding int32/uint32 are read without going through double
+// Numbers which aren't integral or don't fit in T aren't valid
+template<typename T>
+struct Convert<T, std::enable_if_t<std::is_integral_v<T> && sizeof(T) <= sizeof(int32_t)>> {
+    using CType = T;
+    using V8Type = v8::Local<v8::Integer>;
+
+    static bool IsValid(v8::Isolate *isolate, v8::Local<v8::Value> value) {
+        return TryFromV8(isolate, value).has_value();
+    }
+
+    static std::optional<CType> TryFromV8(v8::Isolate *, v8::Local<v8::Value> value) {
+        if (value.IsEmpty() || !value->IsNumber()) {
+            return std::nullopt;
+        }
+        return Read(value);
+    }
+
+    static CType FromV8(v8::Isolate *isolate, v8::Local<v8::Value> value) {
+        if (value.IsEmpty() || !value->IsNumber()) {
+            throw V8BindException("Value is not a valid number");
+        }
+        auto result = Read(value);
+        if (!result) {
+            throw V8BindException("Number is not an integer in range of type");
+        }
+        return *result;
+    }
+
+    static V8Type ToV8(v8::Isolate *isolate, CType value) {
+        if constexpr (std::is_signed_v<T>) {
+            return v8::Integer::New(isolate, static_cast<int32_t>(value));
+        } else {
+            return v8::Integer::NewFromUnsigned(isolate, static_cast<uint32_t>(value));
+        }
+    }
+
+    template<typename R>
+    static void SetReturnValue(v8::ReturnValue<R> return_value, v8::Isolate *, CType value) {
+        if constexpr (std::is_signed_v<T>) {
+            return_value.Set(static_cast<int32_t>(value));
+        } else {
+            return_value.Set(static_cast<uint32_t>(value));
+        }
+    }
+
+private:
+    static std::optional<CType> Read(v8::Local<v8::Value> value) {
+        if constexpr (std::is_signed_v<T>) {
+            if (value->IsInt32()) {
+                auto i = value.As<v8::Int32>()->Value();
+                if (i < std::numeric_limits<T>::min() || i > std::numeric_limits<T>::max()) {
+                    return std::nullopt;
+                }
+                return static_cast<T>(i);
+            }
+        } else {
+            if (value->IsUint32()) {
+                auto u = value.As<v8::Uint32>()->Value();
+                if (u > std::numeric_limits<T>::max()) {
+                    return std::nullopt;
+                }
+                return static_cast<T>(u);
+            }
+        }
+        return impl::IntegralFromNumber<T>(value.As<v8::Number>()->Value());
+    }
+};
+
+template<typename T>
+struct Convert<T, std::enable_if_t<std::is_integral_v<T> && (sizeof(T) > sizeof(int32_t))>> {
+    using CType = T;
+#if V8B_INT64_AS_BIGINT
+    using V8Type = v8::Local<v8::BigInt>;
+#else
+    using V8Type = v8::Local<v8::Number>;
+#endif
+
+    // Number or BigInt out of range of T isn't valid, as well as non-integral Number
+    static bool IsValid(v8::Isolate *isolate, v8::Local<v8::Value> value) {
+        return TryFromV8(isolate, value).has_value();
+    }
+
+    static std::optional<CType> TryFromV8(v8::Isolate *, v8::Local<v8::Value> value) {
+        if (value.IsEmpty()) {
+            return std::nullopt;
+        }
+        if (value->IsNumber()) {
+            return impl::IntegralFromNumber<T>(value.As<v8::Number>()->Value());
+        }
+        if (value->IsBigInt()) {
+            bool lossless;
+            auto result = ReadBigInt(value, &lossless);
+            if (lossless) {
+                return result;
+            }
+        }
+        return std::nullopt;
+    }
+
+    static CType FromV8(v8::Isolate *, v8::Local<v8::Value> value) {
+        if (!value.IsEmpty() && value->IsNumber()) {
+            auto result = impl::IntegralFromNumber<T>(value.As<v8::Number>()->Value());
+            if (!result) {
+                throw V8BindException("Number is not an integer in range of type");
+            }
+            return *result;
+        }
+        if (value.IsEmpty() || !value->IsBigInt()) {
+            throw V8BindException("Value is not a valid number");
+        }
+        bool lossless;
+        auto result = ReadBigInt(value, &lossless);
+        if (!lossless) {
+            throw V8BindException("BigInt is out of range");
+        }
+        return result;
+    }
+
+    static V8Type ToV8(v8::Isolate *isolate, CType value) {
+#if V8B_INT64_AS_BIGINT
+        if constexpr (std::is_signed_v<T>) {
+            return v8::BigInt::New(isolate, static_cast<int64_t>(value));
+        } else {
+            return v8::BigInt::NewFromUnsigned(isolate, static_cast<uint64_t>(value));
+        }
+#else
+        if constexpr (std::is_signed_v<T>) {
+            if (value >= INT32_MIN && value <= INT32_MAX) {
+                return v8::Integer::New(isolate, static_cast<int32_t>(value));
+            }
+        } else {
+            if (value <= UINT32_MAX) {
+                return v8::Integer::NewFromUnsigned(isolate, static_cast<uint32_t>(value));
+            }
+        }
+        return v8::Number::New(isolate, static_cast<double>(value));
+#endif
+    }
+
+#if !V8B_INT64_AS_BIGINT
+    template<typename R>
+    static void SetReturnValue(v8::ReturnValue<R> return_value, v8::Isolate *, CType value) {
+        if constexpr (std::is_signed_v<T>) {
+            if (value >= INT32_MIN && value <= INT32_MAX) {
+                return_value.Set(static_cast<int32_t>(value));
+                return;
+            }
+        } else {
+            if (value <= UINT32_MAX) {
+                return_value.Set(static_cast<uint32_t>(value));
+                return;
+            }
+        }
+        return_value.Set(static_cast<double>(value));
+    }
+#endif
+
+private:
+    static CType ReadBigInt(v8::Local<v8::Value> value, bool *lossless) {
+        if constexpr (std::is_signed_v<T>) {
+            return static_cast<T>(value.As<v8::BigInt>()->Int64Value(lossless));
+        } else {
+            return static_cast<T>(value.As<v8::BigInt>()->Uint64Value(lossless));
+        }
+    }
 };
 
 template<typename T>
@@ -94,22 +352,144 @@ struct Convert<T, std::enable_if_t<std::is_enum_v<T>>> {
     using CType = T;
     using V8Type = v8::Local<v8::Number>;
 
-    static bool IsValid(v8::Isolate *, v8::Local<v8::Value> value) {
-        return !value.IsEmpty() && value->IsNumber();
+    // Number which isn't integral or doesn't fit in underlying type isn't valid
+    static bool IsValid(v8::Isolate *isolate, v8::Local<v8::Value> value) {
+        return TryFromV8(isolate, value).has_value();
+    }
+
+    static std::optional<CType> TryFromV8(v8::Isolate *, v8::Local<v8::Value> value) {
+        if (value.IsEmpty() || !value->IsNumber()) {
+            return std::nullopt;
+        }
+        auto result = impl::IntegralFromNumber<std::underlying_type_t<T>>(value.As<v8::Number>()->Value());
+        if (!result) {
+            return std::nullopt;
+        }
+        return static_cast<T>(*result);
     }
 
     static CType FromV8(v8::Isolate *isolate, v8::Local<v8::Value> value) {
-        if (!IsValid(isolate, value)) {
+        if (value.IsEmpty() || !value->IsNumber()) {
             throw V8BindException("Value is not a valid number");
         }
-        return static_cast<T>(std::underlying_type_t<T>(value.As<v8::Number>()->Value()));
+        auto result = TryFromV8(isolate, value);
+        if (!result) {
+            throw V8BindException("Number is not an integer in range of type");
+        }
+        return *result;
     }
 
     static V8Type ToV8(v8::Isolate *isolate, CType value) {
         return v8::Number::New(isolate, static_cast<double>(std::underlying_type_t<T>(value)));
     }
+
+    template<typename R>
+    static void SetReturnValue(v8::ReturnValue<R> return_value, v8::Isolate *, CType value) {
+        Convert<double>::SetReturnValue(return_value, nullptr, static_cast<double>(std::underlying_type_t<T>(value)));
+    }
 };
 
+namespace impl {
+
+template<typename T>
+struct IsBasicString : std::false_type {};
+
+template<typename Char, typename Traits, typename Alloc>
+struct IsBasicString<std::basic_string<Char, Traits, Alloc>> : std::true_type {};
+
+// Pure ASCII is the same in Latin-1 and UTF-8
+inline bool IsAscii(const char *data, size_t length) {
+    size_t i = 0;
+    for (; i + sizeof(uint64_t) <= length; i += sizeof(uint64_t)) {
+        uint64_t word;
+        std::memcpy(&word, data + i, sizeof(word));
+        if (word & 0x8080808080808080ull) {
+            return false;
+        }
+    }
+    for (; i < length; ++i) {
+        if (static_cast<unsigned char>(data[i]) & 0x80u) {
+            return false;
+        }
+    }
+    return true;
+}
+
+// Writes string as UTF-8 into buffer returned by resize(size), which keeps bytes written
+// before when called again with larger size (as std::string::resize does)
+// One byte strings are written by V8 once as Latin-1 and expanded to UTF-8 in place unless
+// they're pure ASCII (same in UTF-8), external ones are read directly
+template<typename Resize>
+std::string_view WriteUtf8(v8::Isolate *isolate, v8::Local<v8::String> str, Resize &&resize) {
+    if (str->IsExternalOneByte()) {
+        auto source = reinterpret_cast<const uint8_t *>(str->GetExternalOneByteStringResource()->data());
+        auto length = static_cast<size_t>(str->Length());
+        auto size = IsAscii(reinterpret_cast<const char *>(source), length) ?
+                length : transcode::Latin1Utf8Length(source, length);
+        auto buffer = reinterpret_cast<uint8_t *>(resize(size));
+        std::memcpy(buffer, source, length);
+        if (size != length) {
+            transcode::Latin1ToUtf8InPlace(buffer, length, size);
+        }
+        return std::string_view(reinterpret_cast<char *>(buffer), size);
+    }
+    if (str->IsOneByte()) {
+        auto length = static_cast<size_t>(str->Length());
+        auto buffer = reinterpret_cast<uint8_t *>(resize(length));
+        str->WriteOneByte(isolate, buffer, 0, static_cast<int>(length), v8::String::NO_NULL_TERMINATION);
+        if (IsAscii(reinterpret_cast<const char *>(buffer), length)) {
+            return std::string_view(reinterpret_cast<char *>(buffer), length);
+        }
+        auto size = transcode::Latin1Utf8Length(buffer, length);
+        buffer = reinterpret_cast<uint8_t *>(resize(size));
+        transcode::Latin1ToUtf8InPlace(buffer, length, size);
+        return std::string_view(reinterpret_cast<char *>(buffer), size);
+    }
+    auto length = static_cast<size_t>(str->Utf8Length(isolate));
+    char *buffer = resize(length);
+    str->WriteUtf8(isolate, buffer, static_cast<int>(length), nullptr,
+                   v8::String::NO_NULL_TERMINATION | v8::String::REPLACE_INVALID_UTF8);
+    return std::string_view(buffer, length);
+}
+
+// Writes string as UTF-32 into buffer for length code points returned by allocate(length)
+// Returns number of code points written
+template<typename Allocate>
+size_t WriteUtf32(v8::Isolate *isolate, v8::Local<v8::String> str, Allocate &&allocate) {
+    auto length = static_cast<size_t>(str->Length());
+    char32_t *buffer = allocate(length);
+    // Source characters are released right after transcoding
+    auto &scratch = ClassManagerPool::GetScratch(isolate);
+    ScratchStack::Scope scope(scratch);
+    if (str->IsOneByte()) {
+        auto source = static_cast<uint8_t *>(scratch.Allocate(length));
+        str->WriteOneByte(isolate, source, 0, static_cast<int>(length), v8::String::NO_NULL_TERMINATION);
+        transcode::Latin1ToUtf32(source, length, buffer);
+        return length;
+    }
+    auto source = static_cast<uint16_t *>(scratch.Allocate(length * sizeof(uint16_t)));
+    str->Write(isolate, source, 0, static_cast<int>(length), v8::String::NO_NULL_TERMINATION);
+    return transcode::Utf16ToUtf32(source, length, buffer);
+}
+
+// Creates one byte string if all code points fit, two byte string otherwise
+inline v8::Local<v8::String> NewStringFromUtf32(v8::Isolate *isolate, const char32_t *data, size_t length) {
+    auto &scratch = ClassManagerPool::GetScratch(isolate);
+    ScratchStack::Scope scope(scratch);
+    if (transcode::Utf32Mask(data, length) < 0x100u) {
+        auto buffer = static_cast<uint8_t *>(scratch.Allocate(length));
+        transcode::Utf32ToLatin1(data, length, buffer);
+        return v8::String::NewFromOneByte(isolate, buffer, v8::NewStringType::kNormal,
+                                          static_cast<int>(length)).ToLocalChecked();
+    }
+    auto buffer = static_cast<uint16_t *>(scratch.Allocate(2 * length * sizeof(uint16_t)));
+    auto size = transcode::Utf32ToUtf16(data, length, buffer);
+    return v8::String::NewFromTwoByte(isolate, buffer, v8::NewStringType::kNormal,
+                                      static_cast<int>(size)).ToLocalChecked();
+}
+
+} // namespace impl
+
 template<typename Char, typename Traits, typename Alloc>
 struct Convert<std::basic_string<Char, Traits, Alloc>> {
     static_assert(sizeof(Char) <= sizeof(uint32_t),
@@ -122,21 +502,18 @@ struct Convert<std::basic_string<Char, Traits, Alloc>> {
         return !value.IsEmpty() && value->IsString();
     }
 
+    static std::optional<CType> TryFromV8(v8::Isolate *isolate, v8::Local<v8::Value> value) {
+        if (!IsValid(isolate, value)) {
+            return std::nullopt;
+        }
+        return Get(isolate, value);
+    }
+
     static CType FromV8(v8::Isolate* isolate, v8::Local<v8::Value> value) {
         if (!IsValid(isolate, value)) {
             throw V8BindException("Value is not a valid string");
         }
-        if constexpr (sizeof(Char) == 1) {
-            const v8::String::Utf8Value str(isolate, value);
-            return CType(reinterpret_cast<const Char *>(*str));
-        } else if constexpr (sizeof(Char) == 2) {
-            const v8::String::Value str(isolate, value);
-            return CType(reinterpret_cast<const Char *>(*str));
-        } else if constexpr (sizeof(Char) == 4) {
-            const v8::String::Utf8Value str(isolate, value);
-            std::wstring_convert<std::codecvt_utf8<char32_t>, char32_t> cvt;
-            return cvt.from_bytes(*str);
-        }
+        return Get(isolate, value);
     }
 
     static V8Type ToV8(v8::Isolate* isolate, const CType &value) {
@@ -155,95 +532,782 @@ struct Convert<std::basic_string<Char, Traits, Alloc>> {
                 static_cast<int>(value.size())
             ).ToLocalChecked();
         } else if constexpr (sizeof(Char) == 4) {
-            std::wstring_convert<std::codecvt_utf8<char32_t>, char32_t> cvt;
-            auto str = cvt.to_bytes(value.data());
+            return impl::NewStringFromUtf32(isolate, reinterpret_cast<const char32_t *>(value.data()), value.size());
+        }
+    }
+
+    template<typename R>
+    static void SetReturnValue(v8::ReturnValue<R> return_value, v8::Isolate *isolate, const CType &value) {
+        if (value.empty()) {
+            return_value.SetEmptyString();
+        } else {
+            return_value.Set(ToV8(isolate, value));
+        }
+    }
+
+private:
+    // String is written to result directly, without intermediate buffer
+    static CType Get(v8::Isolate* isolate, v8::Local<v8::Value> value) {
+        auto str = value.As<v8::String>();
+        CType result;
+        if constexpr (sizeof(Char) == 1) {
+            auto view = impl::WriteUtf8(isolate, str, [&result](size_t size) {
+                result.resize(size);
+                return reinterpret_cast<char *>(result.data());
+            });
+            result.resize(view.size());
+        } else if constexpr (sizeof(Char) == 2) {
+            result.resize(static_cast<size_t>(str->Length()));
+            str->Write(isolate, reinterpret_cast<uint16_t *>(result.data()), 0, str->Length(),
+                       v8::String::NO_NULL_TERMINATION);
+        } else if constexpr (sizeof(Char) == 4) {
+            auto size = impl::WriteUtf32(isolate, str, [&result](size_t length) {
+                result.resize(length);
+                return reinterpret_cast<char32_t *>(result.data());
+            });
+            result.resize(size);
+        }
+        return result;
+    }
+};
+
+// String views are written to per-isolate scratch memory, it's valid until the end of
+// native call or setter they are passed to, also when nested in containers or value types
+// (or until ScratchStack::Scope ends, if converted manually)
+template<typename Char, typename Traits>
+struct Convert<std::basic_string_view<Char, Traits>> {
+    static_assert(sizeof(Char) <= sizeof(uint32_t),
+                  "Only UTF-8, UTF-16 and UTF-32 string views are supported");
+
+    using CType = std::basic_string_view<Char, Traits>;
+    using V8Type = v8::Local<v8::String>;
+
+    static bool IsValid(v8::Isolate *, v8::Local<v8::Value> value) {
+        return !value.IsEmpty() && value->IsString();
+    }
+
+    static std::optional<CType> TryFromV8(v8::Isolate *isolate, v8::Local<v8::Value> value) {
+        if (!IsValid(isolate, value)) {
+            return std::nullopt;
+        }
+        return Get(isolate, value);
+    }
+
+    static CType FromV8(v8::Isolate* isolate, v8::Local<v8::Value> value) {
+        if (!IsValid(isolate, value)) {
+            throw V8BindException("Value is not a valid string");
+        }
+        return Get(isolate, value);
+    }
+
+    static V8Type ToV8(v8::Isolate* isolate, CType value) {
+        if constexpr (sizeof(Char) == 1) {
             return v8::String::NewFromUtf8(
                 isolate,
-                reinterpret_cast<const char *>(str.data()),
+                reinterpret_cast<const char *>(value.data()),
+                v8::NewStringType::kNormal,
+                static_cast<int>(value.size())
+            ).ToLocalChecked();
+        } else if constexpr (sizeof(Char) == 2) {
+            return v8::String::NewFromTwoByte(
+                isolate,
+                reinterpret_cast<uint16_t const*>(value.data()),
                 v8::NewStringType::kNormal,
-                static_cast<int>(str.size())
+                static_cast<int>(value.size())
             ).ToLocalChecked();
+        } else if constexpr (sizeof(Char) == 4) {
+            return impl::NewStringFromUtf32(isolate, reinterpret_cast<const char32_t *>(value.data()), value.size());
+        }
+    }
+
+private:
+    static CType Get(v8::Isolate* isolate, v8::Local<v8::Value> value) {
+        auto str = value.As<v8::String>();
+        auto &scratch = ClassManagerPool::GetScratch(isolate);
+        if constexpr (sizeof(Char) == 1) {
+            char *buffer = nullptr;
+            size_t allocated = 0;
+            auto view = impl::WriteUtf8(isolate, str, [&scratch, &buffer, &allocated](size_t size) {
+                auto grown = static_cast<char *>(scratch.Allocate(size));
+                if (allocated) {
+                    std::memcpy(grown, buffer, allocated);
+                }
+                buffer = grown;
+                allocated = size;
+                return buffer;
+            });
+            return CType(reinterpret_cast<const Char *>(view.data()), view.size());
+        } else if constexpr (sizeof(Char) == 2) {
+            auto length = static_cast<size_t>(str->Length());
+            auto buffer = static_cast<uint16_t *>(scratch.Allocate(length * sizeof(uint16_t)));
+            str->Write(isolate, buffer, 0, static_cast<int>(length), v8::String::NO_NULL_TERMINATION);
+            return CType(reinterpret_cast<const Char *>(buffer), length);
+        } else if constexpr (sizeof(Char) == 4) {
+            char32_t *buffer = nullptr;
+            auto size = impl::WriteUtf32(isolate, str, [&scratch, &buffer](size_t length) {
+                buffer = static_cast<char32_t *>(scratch.Allocate(length * sizeof(char32_t)));
+                return buffer;
+            });
+            return CType(reinterpret_cast<const Char *>(buffer), size);
+        }
+    }
+};
+
+// Shared strings of at least this many characters are passed to V8 as external strings
+// Shorter ones are copied, as external string has extra allocation and finalization
+#if !defined(V8B_EXTERNAL_STRING_THRESHOLD)
+    #define V8B_EXTERNAL_STRING_THRESHOLD 1024
+#endif
+
+namespace impl {
+
+// Keeps string alive until V8 disposes resource (string is collected or isolate is disposed)
+template<typename Base, typename Char, typename String>
+class SharedStringResource : public Base {
+public:
+    explicit SharedStringResource(std::shared_ptr<const String> string)
+        : string(std::move(string)) {}
+
+    const Char *data() const override {
+        return reinterpret_cast<const Char *>(string->data());
+    }
+
+    size_t length() const override {
+        return string->size();
+    }
+
+private:
+    std::shared_ptr<const String> string;
+};
+
+} // namespace impl
+
+// Shared strings are converted to V8 without copying when possible,
+// V8 string holds reference to native string until it's collected
+template<typename S>
+struct Convert<std::shared_ptr<S>, typename std::enable_if_t<impl::IsBasicString<std::remove_cv_t<S>>::value>> {
+    using String = std::remove_cv_t<S>;
+    using Char = typename String::value_type;
+    using CType = std::shared_ptr<S>;
+    using V8Type = v8::Local<v8::String>;
+
+    static bool IsValid(v8::Isolate *isolate, v8::Local<v8::Value> value) {
+        return Convert<String>::IsValid(isolate, value);
+    }
+
+    static std::optional<CType> TryFromV8(v8::Isolate *isolate, v8::Local<v8::Value> value) {
+        auto result = Convert<String>::TryFromV8(isolate, value);
+        if (!result) {
+            return std::nullopt;
+        }
+        return std::make_shared<String>(std::move(*result));
+    }
+
+    static CType FromV8(v8::Isolate *isolate, v8::Local<v8::Value> value) {
+        return std::make_shared<String>(Convert<String>::FromV8(isolate, value));
+    }
+
+    // Null pointer is converted to empty string
+    static V8Type ToV8(v8::Isolate *isolate, const CType &value) {
+        if (!value) {
+            return v8::String::Empty(isolate);
+        }
+        if (value->size() >= V8B_EXTERNAL_STRING_THRESHOLD
+                && value->size() <= static_cast<size_t>(v8::String::kMaxLength)) {
+            if constexpr (sizeof(Char) == 1) {
+                if (impl::IsAscii(reinterpret_cast<const char *>(value->data()), value->size())) {
+                    // Resource is deleted by V8 with Dispose
+                    return v8::String::NewExternalOneByte(isolate,
+                            new impl::SharedStringResource<v8::String::ExternalOneByteStringResource, char, String>(
+                                    value)).ToLocalChecked();
+                }
+            } else if constexpr (sizeof(Char) == 2) {
+                return v8::String::NewExternalTwoByte(isolate,
+                        new impl::SharedStringResource<v8::String::ExternalStringResource, uint16_t, String>(
+                                value)).ToLocalChecked();
+            }
+        }
+        return Convert<String>::ToV8(isolate, *value);
+    }
+
+    template<typename R>
+    static void SetReturnValue(v8::ReturnValue<R> return_value, v8::Isolate *isolate, const CType &value) {
+        if (!value || value->empty()) {
+            return_value.SetEmptyString();
+        } else {
+            return_value.Set(ToV8(isolate, value));
         }
     }
 };
 
 
-template<typename Key, typename T, typename Comp, typename Alloc>
-struct Convert<std::map<Key, T, Comp, Alloc>> {
-    using CType = std::map<Key, T, Comp, Alloc>;
+namespace impl {
+
+// Associative containers (std::map, std::unordered_map, flat maps, etc.) are detected by member types
+template<typename T, typename Enable = void>
+struct IsMapLike : std::false_type {};
+
+template<typename T>
+struct IsMapLike<T, std::void_t<typename T::key_type, typename T::mapped_type,
+        decltype(std::declval<T &>().begin())>> : std::true_type {};
+
+template<typename T, typename Enable = void>
+struct HasReserve : std::false_type {};
+
+template<typename T>
+struct HasReserve<T, std::void_t<decltype(std::declval<T &>().reserve(size_t()))>> : std::true_type {};
+
+// Multimaps can't be converted, keys of objects and Map objects are unique
+template<typename T, typename Enable = void>
+struct IsMultiMap : std::false_type {};
+
+template<typename T>
+struct IsMultiMap<T, std::enable_if_t<std::is_same_v<decltype(std::declval<T &>().insert(
+        std::declval<const typename T::value_type &>())), typename T::iterator>>> : std::true_type {};
+
+// Keys which can be names of object properties, different keys always get different names
+// Floating point keys aren't (0 and -0 get the same name), they're converted to Map
+template<typename T>
+constexpr bool is_property_key = std::is_integral_v<T> || std::is_enum_v<T>
+        || IsBasicString<T>::value || std::is_same_v<T, std::string_view> || std::is_same_v<T, std::u16string_view>;
+
+// Exact decimal name of integer key, Number doesn't hold every 64-bit value
+template<typename T>
+v8::Local<v8::Name> IntegralName(v8::Isolate *isolate, T value) {
+    char buffer[24];
+    using Wide = std::conditional_t<std::is_signed_v<T>, int64_t, uint64_t>;
+    auto end = std::to_chars(buffer, buffer + sizeof(buffer), static_cast<Wide>(value)).ptr;
+    return v8::String::NewFromOneByte(isolate, reinterpret_cast<const uint8_t *>(buffer),
+                                      v8::NewStringType::kNormal, static_cast<int>(end - buffer)).ToLocalChecked();
+}
+
+} // namespace impl
+
+// Converted from plain objects (own enumerable properties) and Map objects
+// Converted to plain object if keys are strings or integers, otherwise to Map
+template<typename T>
+struct Convert<T, typename std::enable_if_t<impl::IsMapLike<T>::value>> {
+    static_assert(!impl::IsMultiMap<T>::value, "Multimaps can't be converted, keys of JS objects are unique");
+
+    using CType = T;
+    using Key = typename T::key_type;
+    using Value = typename T::mapped_type;
     using V8Type = v8::Local<v8::Object>;
 
     static bool IsValid(v8::Isolate *, v8::Local<v8::Value> value) {
         return !value.IsEmpty() && value->IsObject();
     }
 
-    static CType FromV8(v8::Isolate *isolate, v8::Local<v8::Value> value) {
+    static std::optional<CType> TryFromV8(v8::Isolate *isolate, v8::Local<v8::Value> value) {
         if (!IsValid(isolate, value)) {
-            throw V8BindException("Value is not an object");
+            return std::nullopt;
         }
 
         v8::HandleScope scope(isolate);
         v8::Local<v8::Context> context = isolate->GetCurrentContext();
-        v8::Local<v8::Object> object = value.As<v8::Object>();
-        v8::Local<v8::Array> prop_names = object->GetPropertyNames(context).ToLocalChecked();
 
+        // Map is read as flat array of keys and values
+        bool is_map = value->IsMap();
+        v8::Local<v8::Array> keys;
+        if (is_map) {
+            keys = value.As<v8::Map>()->AsArray();
+        } else {
+            // Integer keys are kept as numbers only for numeric key types
+            auto conversion = std::is_arithmetic_v<Key> || std::is_enum_v<Key>
+                    ? v8::KeyConversionMode::kKeepNumbers : v8::KeyConversionMode::kConvertToString;
+            if (!value.As<v8::Object>()->GetOwnPropertyNames(context,
+                    static_cast<v8::PropertyFilter>(v8::ONLY_ENUMERABLE | v8::SKIP_SYMBOLS),
+                    conversion).ToLocal(&keys)) {
+                return std::nullopt;
+            }
+        }
+
+        uint32_t count = is_map ? keys->Length() / 2 : keys->Length();
         CType result;
-        for (uint32_t i = 0, count = prop_names->Length(); i < count; ++i) {
-            v8::Local<v8::Value> key = prop_names->Get(context, i).ToLocalChecked();
-            v8::Local<v8::Value> val = object->Get(context, key).ToLocalChecked();
-            result.emplace(Convert<Key>::FromV8(isolate, key),
-                           Convert<T>::FromV8(isolate, val));
+        if constexpr (impl::HasReserve<CType>::value) {
+            result.reserve(count);
+        }
+        for (uint32_t i = 0; i < count; ++i) {
+            v8::Local<v8::Value> key, val;
+            if (is_map) {
+                key = keys->Get(context, 2 * i).ToLocalChecked();
+                val = keys->Get(context, 2 * i + 1).ToLocalChecked();
+            } else {
+                key = keys->Get(context, i).ToLocalChecked();
+                if (!value.As<v8::Object>()->Get(context, key).ToLocal(&val)) {
+                    return std::nullopt;
+                }
+            }
+            auto converted_key = Convert<Key>::TryFromV8(isolate, key);
+            if (!converted_key) {
+                return std::nullopt;
+            }
+            auto converted_val = Convert<Value>::TryFromV8(isolate, val);
+            if (!converted_val) {
+                return std::nullopt;
+            }
+            result.emplace(Unpack(converted_key), Unpack(converted_val));
         }
         return result;
     }
 
+    static CType FromV8(v8::Isolate *isolate, v8::Local<v8::Value> value) {
+        auto result = TryFromV8(isolate, value);
+        if (!result) {
+            throw V8BindException("Value is not a valid object");
+        }
+        return std::move(*result);
+    }
+
     static V8Type ToV8(v8::Isolate *isolate, const CType &value) {
         v8::EscapableHandleScope scope(isolate);
         v8::Local<v8::Context> context = isolate->GetCurrentContext();
-        v8::Local<v8::Object> result = v8::Object::New(isolate);
-        for (const auto &p : value) {
-            result->Set(context,
-                        Convert<Key>::ToV8(isolate, p.first),
-                        Convert<T>::ToV8(isolate, p.second));
+
+        if constexpr (impl::is_property_key<Key>) {
+            // Names and values are collected first and object is created at once
+            auto &scratch = ClassManagerPool::GetScratch(isolate);
+            ScratchStack::Scope scratch_scope(scratch);
+            size_t count = value.size();
+            auto names = static_cast<v8::Local<v8::Name> *>(scratch.Allocate(count * sizeof(v8::Local<v8::Name>)));
+            auto values = static_cast<v8::Local<v8::Value> *>(scratch.Allocate(count * sizeof(v8::Local<v8::Value>)));
+            size_t i = 0;
+            for (const auto &p : value) {
+                v8::Local<v8::Name> name;
+                if constexpr (std::is_enum_v<Key>) {
+                    name = impl::IntegralName(isolate, static_cast<std::underlying_type_t<Key>>(p.first));
+                } else if constexpr (std::is_integral_v<Key> && !std::is_same_v<Key, bool>) {
+                    name = impl::IntegralName(isolate, p.first);
+                } else {
+                    v8::Local<v8::Value> key = Convert<Key>::ToV8(isolate, p.first);
+                    if (key->IsName()) {
+                        name = key.As<v8::Name>();
+                    } else {
+                        name = key->ToString(context).ToLocalChecked();
+                    }
+                }
+                v8::Local<v8::Value> val = Convert<Value>::ToV8(isolate, p.second);
+                if (val.IsEmpty()) {
+                    val = v8::Undefined(isolate);
+                }
+                new (names + i) v8::Local<v8::Name>(name);
+                new (values + i) v8::Local<v8::Value>(val);
+                ++i;
+            }
+            auto prototype = ClassManagerPool::GetObjectPrototype(isolate, context);
+            return scope.Escape(v8::Object::New(isolate, prototype, names, values, count));
+        } else {
+            v8::Local<v8::Map> result = v8::Map::New(isolate);
+            for (const auto &p : value) {
+                result = result->Set(context,
+                                     Convert<Key>::ToV8(isolate, p.first),
+                                     Convert<Value>::ToV8(isolate, p.second)).ToLocalChecked();
+            }
+            return scope.Escape(result);
+        }
+    }
+
+private:
+    // Wrapped objects are returned by pointer and copied, they are still owned by JS
+    template<typename U>
+    static decltype(auto) Unpack(U &converted) {
+        if constexpr (std::is_pointer_v<U>) {
+            return *converted;
+        } else {
+            return std::move(*converted);
+        }
+    }
+};
+
+namespace impl {
+
+// Typed array matching element type, numeric vectors are converted to typed arrays
+// with one copy of contents (64-bit integers are left as plain arrays)
+template<typename T>
+struct TypedArrayOf {
+    static constexpr bool value = false;
+};
+
+template<typename V8T, bool (v8::Value::*is)() const>
+struct TypedArrayInfo {
+    static constexpr bool value = true;
+    using type = V8T;
+
+    static bool Is(v8::Local<v8::Value> value) {
+        return ((*value)->*is)();
+    }
+};
+
+template<>
+struct TypedArrayOf<int8_t> : TypedArrayInfo<v8::Int8Array, &v8::Value::IsInt8Array> {};
+
+template<>
+struct TypedArrayOf<uint8_t> : TypedArrayInfo<v8::Uint8Array, &v8::Value::IsUint8Array> {};
+
+template<>
+struct TypedArrayOf<int16_t> : TypedArrayInfo<v8::Int16Array, &v8::Value::IsInt16Array> {};
+
+template<>
+struct TypedArrayOf<uint16_t> : TypedArrayInfo<v8::Uint16Array, &v8::Value::IsUint16Array> {};
+
+template<>
+struct TypedArrayOf<int32_t> : TypedArrayInfo<v8::Int32Array, &v8::Value::IsInt32Array> {};
+
+template<>
+struct TypedArrayOf<uint32_t> : TypedArrayInfo<v8::Uint32Array, &v8::Value::IsUint32Array> {};
+
+template<>
+struct TypedArrayOf<float> : TypedArrayInfo<v8::Float32Array, &v8::Value::IsFloat32Array> {};
+
+template<>
+struct TypedArrayOf<double> : TypedArrayInfo<v8::Float64Array, &v8::Value::IsFloat64Array> {};
+
+// Creates array buffer with copy of data
+inline v8::Local<v8::ArrayBuffer> NewArrayBuffer(v8::Isolate *isolate, const void *data, size_t size) {
+#if V8_MAJOR_VERSION >= 8
+    auto store = v8::ArrayBuffer::NewBackingStore(isolate, size);
+    if (size) {
+        std::memcpy(store->Data(), data, size);
+    }
+    return v8::ArrayBuffer::New(isolate, std::move(store));
+#else
+    auto buffer = v8::ArrayBuffer::New(isolate, size);
+    if (size) {
+        std::memcpy(buffer->GetContents().Data(), data, size);
+    }
+    return buffer;
+#endif
+}
+
+} // namespace impl
+
+namespace impl {
+
+// Elements are converted into scratch buffer first, then array is created from them at once
+template<typename It>
+v8::Local<v8::Array> NewArray(v8::Isolate *isolate, It first, size_t count) {
+    using T = typename std::iterator_traits<It>::value_type;
+    v8::EscapableHandleScope scope(isolate);
+    auto &scratch = ClassManagerPool::GetScratch(isolate);
+    ScratchStack::Scope scratch_scope(scratch);
+    auto elements = static_cast<v8::Local<v8::Value> *>(scratch.Allocate(count * sizeof(v8::Local<v8::Value>)));
+    for (size_t i = 0; i < count; ++i, ++first) {
+        v8::Local<v8::Value> element = Convert<T>::ToV8(isolate, *first);
+        if (element.IsEmpty()) {
+            element = v8::Undefined(isolate);
+        }
+        new (elements + i) v8::Local<v8::Value>(element);
+    }
+    return scope.Escape(v8::Array::New(isolate, elements, count));
+}
+
+// Converts array elements and passes them to add(element) in order
+// Returns false if any element can't be converted
+template<typename T, typename Add>
+bool ReadArray(v8::Isolate *isolate, v8::Local<v8::Array> array, Add &&add) {
+    v8::HandleScope scope(isolate);
+    v8::Local<v8::Context> context = isolate->GetCurrentContext();
+    for (uint32_t i = 0, count = array->Length(); i < count; ++i) {
+        auto element = Convert<T>::TryFromV8(isolate, array->Get(context, i).ToLocalChecked());
+        if (!element) {
+            return false;
+        }
+        // Wrapped objects are returned by pointer and copied, they are still owned by JS
+        if constexpr (std::is_pointer_v<decltype(element)>) {
+            add(*element);
+        } else {
+            add(std::move(*element));
+        }
+    }
+    return true;
+}
+
+// Sequence containers are converted from and to plain arrays
+template<typename Container>
+struct SequenceConvert {
+    using CType = Container;
+    using V8Type = v8::Local<v8::Object>;
+    using T = typename Container::value_type;
+
+    static bool IsValid(v8::Isolate *, v8::Local<v8::Value> value) {
+        return !value.IsEmpty() && value->IsArray();
+    }
+
+    static std::optional<CType> TryFromV8(v8::Isolate *isolate, v8::Local<v8::Value> value) {
+        if (!IsValid(isolate, value)) {
+            return std::nullopt;
+        }
+        CType result;
+        if (!ReadArray<T>(isolate, value.As<v8::Array>(), [&result](auto &&element) {
+            result.push_back(std::forward<decltype(element)>(element));
+        })) {
+            return std::nullopt;
+        }
+        return result;
+    }
+
+    static CType FromV8(v8::Isolate *isolate, v8::Local<v8::Value> value) {
+        auto result = TryFromV8(isolate, value);
+        if (!result) {
+            throw V8BindException("Value is not a valid array");
         }
-        return scope.Escape(result);
+        return std::move(*result);
+    }
+
+    static V8Type ToV8(v8::Isolate *isolate, const CType &value) {
+        return NewArray(isolate, value.begin(), value.size());
     }
 };
 
+} // namespace impl
+
 template<typename T, typename Alloc>
 struct Convert<std::vector<T, Alloc>> {
     using CType = std::vector<T, Alloc>;
     using V8Type = v8::Local<v8::Object>;
 
+    // Numeric vectors also accept typed arrays of matching type
     static bool IsValid(v8::Isolate *, v8::Local<v8::Value> value) {
-        return !value.IsEmpty() && value->IsArray();
+        if constexpr (impl::TypedArrayOf<T>::value) {
+            return !value.IsEmpty() && (value->IsArray() || impl::TypedArrayOf<T>::Is(value));
+        } else {
+            return !value.IsEmpty() && value->IsArray();
+        }
     }
 
-    static CType FromV8(v8::Isolate *isolate, v8::Local<v8::Value> value) {
+    static std::optional<CType> TryFromV8(v8::Isolate *isolate, v8::Local<v8::Value> value) {
         if (!IsValid(isolate, value)) {
-            throw V8BindException("Value is not an array");
+            return std::nullopt;
         }
 
-        v8::HandleScope scope(isolate);
-        v8::Local<v8::Context> context = isolate->GetCurrentContext();
-        v8::Local<v8::Array> array = value.As<v8::Array>();
+        if constexpr (impl::TypedArrayOf<T>::value) {
+            if (!value->IsArray()) {
+                auto typed_array = value.As<v8::TypedArray>();
+                CType result(typed_array->Length());
+                typed_array->CopyContents(result.data(), result.size() * sizeof(T));
+                return result;
+            }
+        }
 
+        auto array = value.As<v8::Array>();
         CType result;
         result.reserve(array->Length());
-        for (uint32_t i = 0, count = array->Length(); i < count; ++i) {
-            result.emplace_back(Convert<T>::FromV8(isolate, array->Get(context, i).ToLocalChecked()));
+        if (!impl::ReadArray<T>(isolate, array, [&result](auto &&element) {
+            result.emplace_back(std::forward<decltype(element)>(element));
+        })) {
+            return std::nullopt;
         }
         return result;
     }
 
+    static CType FromV8(v8::Isolate *isolate, v8::Local<v8::Value> value) {
+        auto result = TryFromV8(isolate, value);
+        if (!result) {
+            throw V8BindException("Value is not a valid array");
+        }
+        return std::move(*result);
+    }
+
     static V8Type ToV8(v8::Isolate *isolate, const CType &value) {
-        v8::EscapableHandleScope scope(isolate);
-        v8::Local<v8::Context> context = isolate->GetCurrentContext();
-        v8::Local<v8::Array> result = v8::Array::New(isolate, (uint32_t)value.size());
-        for (uint32_t i = 0; i < (uint32_t)value.size(); ++i) {
-            result->Set(context, i, Convert<T>::ToV8(isolate, value[i]));
+        using Element = std::remove_cv_t<std::remove_pointer_t<T>>;
+        if constexpr (std::is_pointer_v<T> && IsWrappedClass<Element>::value) {
+            // Wrapped objects are found (or wrapped) in one batch
+            return Class<Element>::FindObjects(isolate,
+                    const_cast<Element *const *>(value.data()), value.size());
+        } else if constexpr (impl::TypedArrayOf<T>::value) {
+            auto buffer = impl::NewArrayBuffer(isolate, value.data(), value.size() * sizeof(T));
+            return impl::TypedArrayOf<T>::type::New(buffer, 0, value.size());
+        } else {
+            return impl::NewArray(isolate, value.begin(), value.size());
+        }
+    }
+};
+
+template<typename T, typename Alloc>
+struct Convert<std::deque<T, Alloc>> : impl::SequenceConvert<std::deque<T, Alloc>> {};
+
+template<typename T, typename Alloc>
+struct Convert<std::list<T, Alloc>> : impl::SequenceConvert<std::list<T, Alloc>> {};
+
+// Converted only from arrays of exactly N elements
+template<typename T, size_t N>
+struct Convert<std::array<T, N>> {
+    using CType = std::array<T, N>;
+    using V8Type = v8::Local<v8::Object>;
+
+    static bool IsValid(v8::Isolate *, v8::Local<v8::Value> value) {
+        return !value.IsEmpty() && value->IsArray() && value.As<v8::Array>()->Length() == N;
+    }
+
+    static std::optional<CType> TryFromV8(v8::Isolate *isolate, v8::Local<v8::Value> value) {
+        if (!IsValid(isolate, value)) {
+            return std::nullopt;
+        }
+        CType result {};
+        size_t i = 0;
+        if (!impl::ReadArray<T>(isolate, value.As<v8::Array>(), [&result, &i](auto &&element) {
+            result[i++] = std::forward<decltype(element)>(element);
+        })) {
+            return std::nullopt;
+        }
+        return result;
+    }
+
+    static CType FromV8(v8::Isolate *isolate, v8::Local<v8::Value> value) {
+        auto result = TryFromV8(isolate, value);
+        if (!result) {
+            throw V8BindException("Value is not a valid array");
+        }
+        return std::move(*result);
+    }
+
+    static V8Type ToV8(v8::Isolate *isolate, const CType &value) {
+        return impl::NewArray(isolate, value.begin(), N);
+    }
+};
+
+namespace impl {
+
+// Contents of array buffer, valid while buffer is alive and not detached
+inline void *ArrayBufferData(v8::Local<v8::ArrayBuffer> buffer) {
+#if V8_MAJOR_VERSION >= 8
+    return buffer->GetBackingStore()->Data();
+#else
+    return buffer->GetContents().Data();
+#endif
+}
+
+template<typename T>
+struct IsTypedArrayVector : std::false_type {};
+
+template<typename T, typename Alloc>
+struct IsTypedArrayVector<std::vector<T, Alloc>> : std::bool_constant<TypedArrayOf<T>::value> {};
+
+} // namespace impl
+
+// Creates array buffer over native memory without copying
+// Owner is kept alive until buffer is collected (on V8 before 8 buffer is externalized and
+// owner is released by weak handle callback, which isn't called when isolate is disposed)
+inline v8::Local<v8::ArrayBuffer> NewExternalArrayBuffer(v8::Isolate *isolate, void *data, size_t size,
+                                                         std::shared_ptr<const void> owner) {
+    if (!size) {
+        return v8::ArrayBuffer::New(isolate, 0);
+    }
+#if V8_MAJOR_VERSION >= 8
+    // Deleter can be called from any thread, shared_ptr reference count is atomic
+    auto store = v8::ArrayBuffer::NewBackingStore(data, size, [](void *, size_t, void *deleter_data) {
+        delete static_cast<std::shared_ptr<const void> *>(deleter_data);
+    }, new std::shared_ptr<const void>(std::move(owner)));
+    return v8::ArrayBuffer::New(isolate, std::move(store));
+#else
+    struct Holder {
+        v8::Global<v8::ArrayBuffer> handle;
+        std::shared_ptr<const void> owner;
+    };
+    auto buffer = v8::ArrayBuffer::New(isolate, data, size, v8::ArrayBufferCreationMode::kExternalized);
+    auto holder = new Holder { v8::Global<v8::ArrayBuffer>(isolate, buffer), std::move(owner) };
+    holder->handle.SetWeak(holder, [](const v8::WeakCallbackInfo<Holder> &info) {
+        delete info.GetParameter();
+    }, v8::WeakCallbackType::kParameter);
+    return buffer;
+#endif
+}
+
+// Points directly into memory of typed array of matching type or array buffer, no copy is made
+// Byte spans accept any array buffer view (DataView, Uint8ClampedArray, etc.)
+// Memory is valid during the call, unless JS called from it detaches the buffer
+template<typename T>
+struct Convert<Span<T>, typename std::enable_if_t<impl::TypedArrayOf<std::remove_cv_t<T>>::value>> {
+    using Element = std::remove_cv_t<T>;
+    using CType = Span<T>;
+    using V8Type = v8::Local<v8::Object>;
+
+    static bool IsValid(v8::Isolate *, v8::Local<v8::Value> value) {
+        if (value.IsEmpty()) {
+            return false;
+        }
+        if (impl::TypedArrayOf<Element>::Is(value)) {
+            return true;
+        }
+        if constexpr (sizeof(Element) == 1) {
+            if (value->IsArrayBufferView()) {
+                return true;
+            }
+        }
+        return value->IsArrayBuffer() && value.As<v8::ArrayBuffer>()->ByteLength() % sizeof(Element) == 0;
+    }
+
+    static std::optional<CType> TryFromV8(v8::Isolate *isolate, v8::Local<v8::Value> value) {
+        if (!IsValid(isolate, value)) {
+            return std::nullopt;
+        }
+        if (value->IsArrayBuffer()) {
+            auto buffer = value.As<v8::ArrayBuffer>();
+            return CType(static_cast<T *>(impl::ArrayBufferData(buffer)), buffer->ByteLength() / sizeof(Element));
+        }
+        // Small typed arrays can be stored on V8 heap, Buffer moves them out, so pointer is stable
+        auto view = value.As<v8::ArrayBufferView>();
+        auto data = static_cast<char *>(impl::ArrayBufferData(view->Buffer())) + view->ByteOffset();
+        return CType(reinterpret_cast<T *>(data), view->ByteLength() / sizeof(Element));
+    }
+
+    static CType FromV8(v8::Isolate *isolate, v8::Local<v8::Value> value) {
+        auto result = TryFromV8(isolate, value);
+        if (!result) {
+            throw V8BindException("Value is not a valid typed array or array buffer");
+        }
+        return *result;
+    }
+
+    // Elements are copied, use NewExternalArrayBuffer to pass memory without copy
+    static V8Type ToV8(v8::Isolate *isolate, CType value) {
+        auto buffer = impl::NewArrayBuffer(isolate, value.data(), value.size_bytes());
+        return impl::TypedArrayOf<Element>::type::New(buffer, 0, value.size());
+    }
+};
+
+// Shared numeric vectors are passed to JS as typed arrays over vector memory,
+// vector is kept alive until typed array is collected
+// Contents stay writable from JS even for vectors of const
+template<typename V>
+struct Convert<std::shared_ptr<V>, typename std::enable_if_t<impl::IsTypedArrayVector<std::remove_cv_t<V>>::value>> {
+    using Vector = std::remove_cv_t<V>;
+    using Element = typename Vector::value_type;
+    using CType = std::shared_ptr<V>;
+    using V8Type = v8::Local<v8::Value>;
+
+    static bool IsValid(v8::Isolate *isolate, v8::Local<v8::Value> value) {
+        return Convert<Vector>::IsValid(isolate, value);
+    }
+
+    static std::optional<CType> TryFromV8(v8::Isolate *isolate, v8::Local<v8::Value> value) {
+        auto result = Convert<Vector>::TryFromV8(isolate, value);
+        if (!result) {
+            return std::nullopt;
+        }
+        return std::make_shared<Vector>(std::move(*result));
+    }
+
+    static CType FromV8(v8::Isolate *isolate, v8::Local<v8::Value> value) {
+        return std::make_shared<Vector>(Convert<Vector>::FromV8(isolate, value));
+    }
+
+    // Null pointer is converted to null
+    static V8Type ToV8(v8::Isolate *isolate, const CType &value) {
+        if (!value) {
+            return v8::Null(isolate);
+        }
+        auto buffer = NewExternalArrayBuffer(isolate, const_cast<Element *>(value->data()),
+                                             value->size() * sizeof(Element), value);
+        return impl::TypedArrayOf<Element>::type::New(buffer, 0, value->size());
+    }
+
+    template<typename R>
+    static void SetReturnValue(v8::ReturnValue<R> return_value, v8::Isolate *isolate, const CType &value) {
+        if (!value) {
+            return_value.SetNull();
+        } else {
+            return_value.Set(ToV8(isolate, value));
         }
-        return scope.Escape(result);
     }
 };
 
@@ -257,7 +1321,11 @@ template<>
 struct Convert<const char32_t *> : Convert<std::u32string> {};
 
 template<typename T>
-struct IsWrappedClass : std::is_class<T> {};
+struct IsWrappedClass : std::bool_constant<std::is_class_v<T>
+        && !impl::IsMapLike<T>::value && !IsValueType<T>::value> {};
+
+template<typename T>
+struct IsWrappedClass<const T> : IsWrappedClass<T> {};
 
 template<typename T>
 struct IsWrappedClass<v8::Local<T>> : std::false_type {};
@@ -268,15 +1336,70 @@ struct IsWrappedClass<v8::Global<T>> : std::false_type {};
 template<typename Char, typename Traits, typename Alloc>
 struct IsWrappedClass<std::basic_string<Char, Traits, Alloc>> : std::false_type {};
 
-template<typename Key, typename T, typename Comp, typename Alloc>
-struct IsWrappedClass<std::map<Key, T, Comp, Alloc>> : std::false_type {};
+template<typename Char, typename Traits>
+struct IsWrappedClass<std::basic_string_view<Char, Traits>> : std::false_type {};
 
 template<typename T, typename Alloc>
 struct IsWrappedClass<std::vector<T, Alloc>> : std::false_type {};
 
+template<typename T, typename Alloc>
+struct IsWrappedClass<std::deque<T, Alloc>> : std::false_type {};
+
+template<typename T, typename Alloc>
+struct IsWrappedClass<std::list<T, Alloc>> : std::false_type {};
+
+template<typename T, size_t N>
+struct IsWrappedClass<std::array<T, N>> : std::false_type {};
+
+template<typename T>
+struct IsWrappedClass<Span<T>> : std::false_type {};
+
 template<typename T>
 struct IsWrappedClass<std::shared_ptr<T>> : std::false_type {};
 
+template<typename T>
+struct IsWrappedClass<std::weak_ptr<T>> : std::false_type {};
+
+
+// Value types are copied to and from plain objects, see ValueType
+template<typename T>
+struct Convert<T, typename std::enable_if_t<IsValueType<T>::value>> {
+    using CType = T;
+    using V8Type = v8::Local<v8::Object>;
+
+    static bool IsValid(v8::Isolate *isolate, v8::Local<v8::Value> value) {
+        return TryFromV8(isolate, value).has_value();
+    }
+
+    static std::optional<CType> TryFromV8(v8::Isolate *isolate, v8::Local<v8::Value> value) {
+        CType result {};
+        if (!GetManager(isolate).FromV8(value, &result)) {
+            return std::nullopt;
+        }
+        return result;
+    }
+
+    static CType FromV8(v8::Isolate *isolate, v8::Local<v8::Value> value) {
+        auto result = TryFromV8(isolate, value);
+        if (!result) {
+            throw V8BindException("Value is not a valid object");
+        }
+        return std::move(*result);
+    }
+
+    static V8Type ToV8(v8::Isolate *isolate, const CType &value) {
+        return GetManager(isolate).ToV8(&value);
+    }
+
+private:
+    static ValueTypeManager &GetManager(v8::Isolate *isolate) {
+        auto manager = ClassManagerPool::FindValueType(isolate, TypeInfo::GetIndexOf<T>());
+        if (!manager) {
+            throw V8BindException(std::string() + "Value type isn't registered [" + TypeInfo::Get<T>().GetName() + "]");
+        }
+        return *manager;
+    }
+};
 
 template<typename T>
 struct Convert<T *, typename std::enable_if_t<IsWrappedClass<T>::value>> {
@@ -284,22 +1407,26 @@ struct Convert<T *, typename std::enable_if_t<IsWrappedClass<T>::value>> {
     using V8Type = v8::Local<v8::Object>;
 
     static bool IsValid(v8::Isolate *isolate, v8::Local<v8::Value> value) {
+        return TryFromV8(isolate, value).has_value();
+    }
+
+    static std::optional<CType> TryFromV8(v8::Isolate *isolate, v8::Local<v8::Value> value) {
         if (value.IsEmpty() || !value->IsObject()) {
-            return false;
+            return std::nullopt;
         }
-        try {
-            Class<std::remove_cv_t<T>>::UnwrapObject(isolate, value);
-        } catch (const V8BindException &) {
-            return false;
+        auto ptr = Class<std::remove_cv_t<T>>::TryUnwrapObject(isolate, value);
+        if (!ptr) {
+            return std::nullopt;
         }
-        return true;
+        return ptr;
     }
 
     static CType FromV8(v8::Isolate *isolate, v8::Local<v8::Value> value) {
-        if (!IsValid(isolate, value)) {
+        auto result = TryFromV8(isolate, value);
+        if (!result) {
             throw V8BindException("Value is not a valid object");
         }
-        return Class<std::remove_cv_t<T>>::UnwrapObject(isolate, value);
+        return *result;
     }
 
     static V8Type ToV8(v8::Isolate *isolate, CType value) {
@@ -316,6 +1443,11 @@ struct Convert<T, typename std::enable_if_t<IsWrappedClass<T>::value>> {
         return Convert<T *>::IsValid(isolate, value);
     }
 
+    // Reference can't be stored in std::optional, so pointer is returned
+    static T *TryFromV8(v8::Isolate *isolate, v8::Local<v8::Value> value) {
+        return Convert<T *>::TryFromV8(isolate, value).value_or(nullptr);
+    }
+
     static CType FromV8(v8::Isolate *isolate, v8::Local<v8::Value> value) {
         auto ptr = Convert<T *>::FromV8(isolate, value);
         if (!ptr) {
@@ -342,15 +1474,67 @@ struct Convert<std::shared_ptr<T>, typename std::enable_if_t<IsWrappedClass<T>::
         return Convert<T>::IsValid(isolate, value);
     }
 
+    static std::optional<CType> TryFromV8(v8::Isolate *isolate, v8::Local<v8::Value> value) {
+        auto ptr = Convert<T>::TryFromV8(isolate, value);
+        if (!ptr) {
+            return std::nullopt;
+        }
+        return SharedPointerManager<std::remove_cv_t<T>>::GetSharedPointer(
+                isolate, const_cast<std::remove_cv_t<T> *>(ptr));
+    }
+
     static CType FromV8(v8::Isolate *isolate, v8::Local<v8::Value> value) {
-        if (!IsValid(isolate, value)) {
+        auto result = TryFromV8(isolate, value);
+        if (!result) {
             throw V8BindException("Value is not a valid object");
         }
-        return SharedPointerManager<std::remove_cv_t<T>>::UnwrapObject(isolate, value);
+        return std::move(*result);
     }
 
-    static V8Type ToV8(v8::Isolate *isolate, CType value) {
-        return SharedPointerManager<std::remove_cv_t<T>>::FindObject(isolate, value);
+    static V8Type ToV8(v8::Isolate *isolate, const CType &value) {
+        return SharedPointerManager<std::remove_cv_t<T>>::FindObject(isolate,
+                std::const_pointer_cast<std::remove_cv_t<T>>(value));
+    }
+};
+
+template<typename T>
+struct Convert<std::weak_ptr<T>, typename std::enable_if_t<IsWrappedClass<T>::value>> {
+    using CType = std::weak_ptr<T>;
+    using V8Type = v8::Local<v8::Value>;
+
+    static bool IsValid(v8::Isolate *isolate, v8::Local<v8::Value> value) {
+        return Convert<std::shared_ptr<T>>::IsValid(isolate, value);
+    }
+
+    static std::optional<CType> TryFromV8(v8::Isolate *isolate, v8::Local<v8::Value> value) {
+        auto ptr = Convert<std::shared_ptr<T>>::TryFromV8(isolate, value);
+        if (!ptr) {
+            return std::nullopt;
+        }
+        return CType(*ptr);
+    }
+
+    static CType FromV8(v8::Isolate *isolate, v8::Local<v8::Value> value) {
+        return Convert<std::shared_ptr<T>>::FromV8(isolate, value);
+    }
+
+    // Expired pointer is converted to null
+    static V8Type ToV8(v8::Isolate *isolate, const CType &value) {
+        auto ptr = value.lock();
+        if (!ptr) {
+            return v8::Null(isolate);
+        }
+        return Convert<std::shared_ptr<T>>::ToV8(isolate, ptr);
+    }
+
+    template<typename R>
+    static void SetReturnValue(v8::ReturnValue<R> return_value, v8::Isolate *isolate, const CType &value) {
+        auto ptr = value.lock();
+        if (!ptr) {
+            return_value.SetNull();
+        } else {
+            return_value.Set(Convert<std::shared_ptr<T>>::ToV8(isolate, ptr));
+        }
     }
 };
 
@@ -384,6 +1568,27 @@ inline decltype(auto) ToV8(v8::Isolate *isolate, const char32_t *c) {
     return Convert<std::u32string>::ToV8(isolate, std::u32string(c));
 }
 
+namespace impl {
+
+template<typename T, typename R, typename Enable = void>
+struct HasSetReturnValue : std::false_type {};
+
+template<typename T, typename R>
+struct HasSetReturnValue<T, R, std::void_t<decltype(Convert<T>::SetReturnValue(
+        std::declval<v8::ReturnValue<R>>(), std::declval<v8::Isolate *>(), std::declval<T>()))>> : std::true_type {};
+
+// Sets converted value as callback result, through Convert<T>::SetReturnValue if it's provided
+template<typename R, typename T>
+void SetReturnValue(v8::ReturnValue<R> return_value, v8::Isolate *isolate, T &&value) {
+    if constexpr (HasSetReturnValue<T, R>::value) {
+        Convert<T>::SetReturnValue(return_value, isolate, std::forward<T>(value));
+    } else {
+        return_value.Set(ToV8(isolate, std::forward<T>(value)));
+    }
+}
+
+}
+
 }
 
 #endif //SANDWICH_V8B_CONVERT_HPP
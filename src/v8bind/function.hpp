@@ -19,15 +19,18 @@
 #include <stdexcept>
 #include <iostream>
 #include <memory>
+#include <array>
+#include <new>
+#include <limits>
 
 namespace v8b {
 
 // Class wrapping copy of any data in v8::Local
-// Lifetime of such object is controlled by V8 GC
+// Data lives as long as bindings of isolate (until ClassManagerPool::RemoveAll)
 class ExternalData {
 public:
     // Any primitive that will fit in sizeof(void *) will be just copied
-    // Otherwise object will be copied to container with lifetime bound to Weak Persistent handle
+    // Otherwise object will be copied to per-isolate binding arena and external holds pointer to it
     template<typename T>
     static constexpr bool is_bitcast_allowed =
             sizeof(T) <= sizeof(void*) &&
@@ -36,58 +39,28 @@ public:
 
     template<typename T>
     static v8::Local<v8::Value> New(v8::Isolate* isolate, T &&data) {
-        if constexpr (is_bitcast_allowed<T>) {
+        using U = std::decay_t<T>;
+        if constexpr (is_bitcast_allowed<U>) {
             void *ptr;
             std::memcpy(&ptr, &data, sizeof(data));
             return v8::External::New(isolate, ptr);
         } else {
-            return DataHolder<T>::New(isolate, std::forward<T>(data));
+            return v8::External::New(isolate, ClassManagerPool::GetBindings(isolate).New<U>(std::forward<T>(data)));
         }
     }
 
     template<typename T>
     static decltype(auto) Unwrap(v8::Local<v8::Value> value) {
-        if constexpr (is_bitcast_allowed<T>) {
+        using U = std::decay_t<T>;
+        if constexpr (is_bitcast_allowed<U>) {
             void *ptr = value.As<v8::External>()->Value();
-            T data;
+            U data;
             std::memcpy(&data, &ptr, sizeof(data));
             return data;
         } else {
-            auto data_holder = static_cast<DataHolder<T> *>(value.As<v8::External>()->Value());
-            return data_holder->Get();
+            return *static_cast<U *>(value.As<v8::External>()->Value());
         }
     }
-
-private:
-    template<typename T>
-    struct DataHolder {
-        T &Get() {
-            return *static_cast<T *>(static_cast<void *>(&storage));
-        }
-
-        static v8::Local<v8::Value> New(v8::Isolate *isolate, T &&data) {
-            auto data_holder = new DataHolder<T>;
-            new (data_holder->GetData()) T(std::forward<T>(data));
-            auto external = v8::External::New(isolate, data_holder);
-            data_holder->handle.Reset(isolate, external);
-            data_holder->handle.SetWeak(data_holder, [](const v8::WeakCallbackInfo<DataHolder<T>> &data) {
-                std::unique_ptr<DataHolder<T>> d_h(data.GetParameter());
-                if (!d_h->handle.IsEmpty()) {
-                    d_h->GetData()->~T();
-                    d_h->handle.Reset();
-                }
-            }, v8::WeakCallbackType::kParameter);
-            return external;
-        }
-
-    private:
-        std::aligned_storage_t<sizeof(T), alignof(T)> storage;
-        v8::Global<v8::External> handle;
-
-        T *GetData() {
-            return static_cast<T *>(static_cast<void *>(&storage));
-        }
-    };
 };
 
 struct MemberCall {};
@@ -95,57 +68,64 @@ struct StaticCall {};
 
 namespace impl {
 
-template<typename CallType, bool wrap_return_value, typename F, size_t ...Indices>
+// Arguments passed from JS side (without "this" for member call)
+template<typename CallType, typename F>
+struct JSArguments {
+    using type = typename traits::function_traits<F>::arguments;
+};
+
+template<typename F>
+struct JSArguments<MemberCall, F> {
+    using type = traits::tuple_tail_t<typename traits::function_traits<F>::arguments>;
+};
+
+template<typename CallType, typename F>
+using ConvertedArguments = traits::ConvertedArguments<typename JSArguments<CallType, F>::type>;
+
+template<typename CallType, bool wrap_return_value, typename F, typename CA, size_t ...Indices>
 decltype(auto) CallNativeFromV8Impl(F &&f, const v8::FunctionCallbackInfo<v8::Value> &info,
-                          std::index_sequence<Indices...>) {
+                          CA &arguments, std::index_sequence<Indices...>) {
     using Arguments = typename traits::function_traits<F>::arguments;
     using ReturnType = typename traits::function_traits<F>::return_type;
 
     if constexpr (std::is_same_v<CallType, StaticCall>) {
-        if constexpr (std::tuple_size_v<Arguments> == 1) {
-            if constexpr (
-                    std::is_same_v<std::tuple_element_t<0, Arguments>, const v8::FunctionCallbackInfo<v8::Value> &>) {
-                return std::invoke(std::forward<F>(f), info);
-            }
-        }
-
-        if constexpr (std::is_same_v<ReturnType, void>) {
-            return std::invoke(std::forward<F>(f),
-                        FromV8<std::tuple_element_t<Indices, Arguments>>(info.GetIsolate(), info[Indices])...);
+        if constexpr (std::is_same_v<Arguments, std::tuple<const v8::FunctionCallbackInfo<v8::Value> &>>) {
+            return std::invoke(std::forward<F>(f), info);
+        } else if constexpr (std::is_same_v<ReturnType, void>) {
+            return std::invoke(std::forward<F>(f), arguments.template Get<Indices>()...);
         } else {
-            decltype(auto) result = std::invoke(std::forward<F>(f),
-                                      FromV8<std::tuple_element_t<Indices, Arguments>>(
-                                              info.GetIsolate(), info[Indices])...);
+            decltype(auto) result = std::invoke(std::forward<F>(f), arguments.template Get<Indices>()...);
             if constexpr (wrap_return_value) {
-                info.GetReturnValue().Set(ToV8(info.GetIsolate(), result));
+                impl::SetReturnValue(info.GetReturnValue(), info.GetIsolate(), result);
             }
             return result;
         }
     } else if (std::is_same_v<CallType, MemberCall>) {
         decltype(auto) object = FromV8<std::tuple_element_t<0, Arguments>>(info.GetIsolate(), info.This());
 
-        if constexpr (std::tuple_size_v<Arguments> == 2) {
-            if constexpr (
-                    std::is_same_v<std::tuple_element_t<1, Arguments>, const v8::FunctionCallbackInfo<v8::Value> &>) {
-                return std::invoke(std::forward<F>(f), object, info);
-            }
-        }
-
-        if constexpr (std::is_same_v<ReturnType, void>) {
-            return std::invoke(std::forward<F>(f), object,
-                        FromV8<std::tuple_element_t<Indices + 1, Arguments>>(info.GetIsolate(), info[Indices])...);
+        if constexpr (std::is_same_v<traits::tuple_tail_t<Arguments>,
+                                     std::tuple<const v8::FunctionCallbackInfo<v8::Value> &>>) {
+            return std::invoke(std::forward<F>(f), object, info);
+        } else if constexpr (std::is_same_v<ReturnType, void>) {
+            return std::invoke(std::forward<F>(f), object, arguments.template Get<Indices>()...);
         } else {
-            decltype(auto) result = std::invoke(std::forward<F>(f), object,
-                                      FromV8<std::tuple_element_t<Indices + 1, Arguments>>(
-                                              info.GetIsolate(), info[Indices])...);
+            decltype(auto) result = std::invoke(std::forward<F>(f), object, arguments.template Get<Indices>()...);
             if constexpr (wrap_return_value) {
-                info.GetReturnValue().Set(ToV8(info.GetIsolate(), result));
+                impl::SetReturnValue(info.GetReturnValue(), info.GetIsolate(), result);
             }
             return result;
         }
     }
 }
 
+// Call function with arguments already converted by ConvertedArguments::FromV8
+template<typename CallType, bool wrap_return_value, typename F>
+decltype(auto) CallNativeFromV8Converted(F &&f, const v8::FunctionCallbackInfo<v8::Value> &info,
+                                         ConvertedArguments<CallType, F> &arguments) {
+    using Indices = std::make_index_sequence<std::tuple_size_v<typename JSArguments<CallType, F>::type>>;
+    return CallNativeFromV8Impl<CallType, wrap_return_value>(std::forward<F>(f), info, arguments, Indices {});
+}
+
 } // namespace impl
 
 // Call any V8 function from C++ with arguments conversion
@@ -180,38 +160,95 @@ decltype(auto) CallNativeFromV8(F &&f, const v8::FunctionCallbackInfo<v8::Value>
     static_assert(std::is_same_v<CallType, MemberCall> || std::is_same_v<CallType, StaticCall>,
                   "CallType must be either MemberCall or StaticCall");
 
-    using Arguments = typename traits::function_traits<F>::arguments;
+    impl::ConvertedArguments<CallType, F> arguments;
+    if (!arguments.FromV8(info)) {
+        throw CallException("Arguments don't match");
+    }
+    return impl::CallNativeFromV8Converted<CallType, wrap_return_value>(std::forward<F>(f), info, arguments);
+}
 
-    if constexpr (std::is_same_v<CallType, StaticCall>) {
-        if (!traits::ArgumentTraits<Arguments>::IsMatch(info)) {
-            throw CallException("Arguments don't match");
-        }
-        using Indices = std::make_index_sequence<std::tuple_size_v<Arguments>>;
-        return impl::CallNativeFromV8Impl<CallType, wrap_return_value>(std::forward<F>(f), info, Indices {});
-    } else if (std::is_same_v<CallType, MemberCall>) {
-        if (!traits::ArgumentTraits<traits::tuple_tail_t<Arguments>>::IsMatch(info)) {
-            throw CallException("Arguments don't match");
+namespace impl {
+
+// Arity of functions taking raw v8::FunctionCallbackInfo, they accept any arguments count
+constexpr size_t variadic_arity = std::numeric_limits<size_t>::max();
+
+template<typename CallType, typename F>
+constexpr size_t FunctionArity() {
+    using Arguments = typename JSArguments<CallType, F>::type;
+    if constexpr (std::is_same_v<Arguments, std::tuple<const v8::FunctionCallbackInfo<v8::Value> &>>) {
+        return variadic_arity;
+    } else {
+        return std::tuple_size_v<Arguments>;
+    }
+}
+
+// Max arity among functions with fixed arguments count
+template<typename CallType, typename ...FS>
+constexpr size_t MaxArity() {
+    constexpr size_t arities[] = { 0, FunctionArity<CallType, FS>()... };
+    size_t result = 0;
+    for (size_t arity : arities) {
+        if (arity != variadic_arity && arity > result) {
+            result = arity;
         }
-        using Indices = std::make_index_sequence<std::tuple_size_v<Arguments> - 1>;
-        return impl::CallNativeFromV8Impl<CallType, wrap_return_value>(std::forward<F>(f), info, Indices {});
     }
+    return result;
 }
 
-// Try sequentially call functions from functions tuple
-// and stop on first successful call
-template<typename CallType, size_t index = 0, typename ...FS>
-void SelectAndCall(
+template<typename CallType, size_t arity, size_t index, typename ...FS>
+bool TryCallWithArity(
         const v8::FunctionCallbackInfo<v8::Value> &info,
         const std::tuple<FS...> &functions) {
-    if constexpr (index < std::tuple_size_v<std::tuple<FS...>>) {
-        try {
-            CallNativeFromV8<CallType>(std::get<index>(functions), info);
-        } catch (const CallException &e) {
-            SelectAndCall<CallType, index + 1>(info, functions);
+    using F = std::tuple_element_t<index, std::tuple<FS...>>;
+    constexpr size_t function_arity = FunctionArity<CallType, F>();
+    if constexpr (function_arity == arity || function_arity == variadic_arity) {
+        ConvertedArguments<CallType, F> arguments;
+        if (arguments.FromV8(info)) {
+            CallNativeFromV8Converted<CallType, true>(std::get<index>(functions), info, arguments);
+            return true;
         }
-    } else {
-        throw CallException("No suitable function found to call");
     }
+    return false;
+}
+
+// Try only functions which can accept arity arguments, in declaration order
+template<typename CallType, size_t arity, typename ...FS, size_t ...Indices>
+bool SelectAndCallWithArityImpl(
+        const v8::FunctionCallbackInfo<v8::Value> &info,
+        const std::tuple<FS...> &functions,
+        std::index_sequence<Indices...>) {
+    return (TryCallWithArity<CallType, arity, Indices>(info, functions) || ...);
+}
+
+template<typename CallType, size_t arity, typename ...FS>
+bool SelectAndCallWithArity(
+        const v8::FunctionCallbackInfo<v8::Value> &info,
+        const std::tuple<FS...> &functions) {
+    return SelectAndCallWithArityImpl<CallType, arity>(info, functions, std::index_sequence_for<FS...> {});
+}
+
+// Dispatch table indexed by arguments count, last bucket holds only variadic functions
+template<typename CallType, typename ...FS, size_t ...Arities>
+constexpr auto MakeArityTable(std::index_sequence<Arities...>) {
+    using Selector = bool (*)(const v8::FunctionCallbackInfo<v8::Value> &, const std::tuple<FS...> &);
+    return std::array<Selector, sizeof...(Arities)> { &SelectAndCallWithArity<CallType, Arities, FS...>... };
+}
+
+} // namespace impl
+
+// Call first function from functions tuple with matching arguments
+// Functions are bucketed by arity at compile time, so only candidates
+// able to accept info.Length() arguments are checked (in declaration order)
+// Returns false if no suitable function found, nothing is thrown in such case
+template<typename CallType, typename ...FS>
+bool SelectAndCall(
+        const v8::FunctionCallbackInfo<v8::Value> &info,
+        const std::tuple<FS...> &functions) {
+    constexpr size_t max_arity = impl::MaxArity<CallType, FS...>();
+    static constexpr auto table =
+            impl::MakeArityTable<CallType, FS...>(std::make_index_sequence<max_arity + 2> {});
+    auto length = static_cast<size_t>(info.Length());
+    return table[length <= max_arity ? length : max_arity + 1](info, functions);
 }
 
 // Wrap functions as overloads of one js function
@@ -230,25 +267,31 @@ v8::Local<v8::FunctionTemplate> WrapFunction(v8::Isolate *isolate, F&&... f) {
     return scope.Escape(v8::FunctionTemplate::New(isolate, [](const v8::FunctionCallbackInfo<v8::Value> &info) {
         try {
             auto &extracted_functions = ExternalData::Unwrap<decltype(functions)>(info.Data());
-            SelectAndCall<CallType>(info, extracted_functions);
+            if (!SelectAndCall<CallType>(info, extracted_functions)) {
+                throw CallException("No suitable function found to call");
+            }
         } catch (const V8BindException &e) {
             info.GetIsolate()->ThrowException(v8::Exception::Error(ToV8(info.GetIsolate(), e.what())));
         }
     }, ExternalData::New(isolate, std::move(functions))));
 }
 
-template<size_t index = 0, typename ...FS>
-decltype(auto) SelectAndCallConstructor(
+// Try sequentially call constructors from constructors tuple
+// and stop on first constructor with matching arguments
+// Returns false if no suitable constructor found, nothing is thrown in such case
+template<size_t index = 0, typename R, typename ...FS>
+bool SelectAndCallConstructor(
         const v8::FunctionCallbackInfo<v8::Value> &args,
-        const std::tuple<FS...> &constructors) {
+        const std::tuple<FS...> &constructors, R &result) {
     if constexpr (index < std::tuple_size_v<std::tuple<FS...>>) {
-        try {
-            return CallNativeFromV8<StaticCall, false>(std::get<index>(constructors), args);
-        } catch (const CallException &e) {
-            return SelectAndCallConstructor<index + 1>(args, constructors);
+        impl::ConvertedArguments<StaticCall, std::tuple_element_t<index, std::tuple<FS...>>> arguments;
+        if (arguments.FromV8(args)) {
+            result = impl::CallNativeFromV8Converted<StaticCall, false>(std::get<index>(constructors), args, arguments);
+            return true;
         }
+        return SelectAndCallConstructor<index + 1>(args, constructors, result);
     } else {
-        throw CallException("No suitable constructor found to call");
+        return false;
     }
 }
 
@@ -262,7 +305,12 @@ void WrapConstructor(v8::Isolate *isolate, F&&... f, v8::Local<v8::FunctionTempl
     t->SetCallHandler([](const v8::FunctionCallbackInfo<v8::Value> &args) {
         try {
             auto &extracted_constructors = ExternalData::Unwrap<decltype(constructors)>(args.Data());
-            auto o = SelectAndCallConstructor(args, extracted_constructors);
+            using ReturnType = typename traits::function_traits<
+                    std::tuple_element_t<0, decltype(constructors)>>::return_type;
+            ReturnType o {};
+            if (!SelectAndCallConstructor(args, extracted_constructors, o)) {
+                throw CallException("No suitable constructor found to call");
+            }
             args.GetReturnValue().Set(Class<std::remove_pointer_t<decltype(o)>>::WrapObject(args.GetIsolate(), o, true));
         } catch (const V8BindException &e) {
             args.GetIsolate()->ThrowException(v8::Exception::Error(ToV8(args.GetIsolate(), e.what())));
@@ -273,29 +321,30 @@ void WrapConstructor(v8::Isolate *isolate, F&&... f, v8::Local<v8::FunctionTempl
 namespace impl {
 
 template<typename T, typename AS, size_t ...Indices>
-T *CallConstructorImpl(const v8::FunctionCallbackInfo<v8::Value> &info,
+T *CallConstructorImpl(traits::ConvertedArguments<AS> &arguments, void *memory,
                        std::index_sequence<Indices...>) {
-    return new T(FromV8<std::tuple_element_t<Indices, AS>>(
-            info.GetIsolate(), info[Indices])...);
+    if (memory) {
+        return new (memory) T(arguments.template Get<Indices>()...);
+    }
+    return new T(arguments.template Get<Indices>()...);
 }
 
 } // namespace impl
 
-template<typename T, typename AS>
-T *CallConstructor(const v8::FunctionCallbackInfo<v8::Value> &args) {
-    if (!traits::ArgumentTraits<AS>::IsMatch(args)) {
+// Call first constructor with signature matching passed arguments
+// Object is constructed in memory if it's passed, else allocated with new
+template<typename T, typename AS, typename ...Rest>
+T *CallConstructor(const v8::FunctionCallbackInfo<v8::Value> &args, void *memory = nullptr) {
+    traits::ConvertedArguments<AS> arguments;
+    if (arguments.FromV8(args)) {
+        using indices = std::make_index_sequence<std::tuple_size_v<AS>>;
+        return impl::CallConstructorImpl<T, AS>(arguments, memory, indices {});
+    }
+    if constexpr (sizeof...(Rest) > 0) {
+        return CallConstructor<T, Rest...>(args, memory);
+    } else {
         throw CallException("No suitable constructor found");
     }
-    using indices = std::make_index_sequence<std::tuple_size_v<AS>>;
-    return impl::CallConstructorImpl<T, AS>(args, indices {});
-}
-
-template<typename T, typename AS1, typename AS2, typename ...Args>
-T *CallConstructor(const v8::FunctionCallbackInfo<v8::Value> &args) {
-    try {
-        return CallConstructor<T, AS1>(args);
-    } catch (const CallException &) {}
-    return CallConstructor<T, AS2, Args...>(args);
 }
 
 }
@@ -28,10 +28,10 @@ V8B_IMPL AccessorData VarAccessor(v8::Isolate *isolate, V &&var) {
                 static_assert(std::is_member_object_pointer_v<V>, "Var must be pointer to member data");
                 auto obj = Class<typename v8b::traits::function_traits<V>::class_type>
                         ::UnwrapObject(info.GetIsolate(), info.This());
-                info.GetReturnValue().Set(ToV8(info.GetIsolate(), (*obj).*v));
+                impl::SetReturnValue(info.GetReturnValue(), info.GetIsolate(), (*obj).*v);
             } else {
                 static_assert(std::is_pointer_v<V>, "V should be a pointer to variable");
-                info.GetReturnValue().Set(ToV8(info.GetIsolate(), *v));
+                impl::SetReturnValue(info.GetReturnValue(), info.GetIsolate(), *v);
             }
         } catch (const V8BindException &e) {
             info.GetIsolate()->ThrowException(v8::Exception::Error(ToV8(info.GetIsolate(), e.what())));
@@ -49,10 +49,13 @@ V8B_IMPL AccessorData VarAccessor(v8::Isolate *isolate, V &&var) {
             try {
                 auto v = ExternalData::Unwrap<V>(info.Data());
                 if constexpr (is_member) {
+                    using Type = typename traits::function_traits<V>::return_type;
+                    impl::ScratchScope<Type> scratch(info.GetIsolate());
                     auto obj = Class<typename v8b::traits::function_traits<V>::class_type>
                             ::UnwrapObject(info.GetIsolate(), info.This());
                     (*obj).*v = FromV8<typename traits::function_traits<V>::return_type>(info.GetIsolate(), value);
                 } else {
+                    impl::ScratchScope<std::remove_pointer_t<V>> scratch(info.GetIsolate());
                     *v = FromV8<std::remove_pointer_t<V>>(info.GetIsolate(), value);
                 }
             } catch (const V8BindException &e) {
@@ -70,6 +73,75 @@ V8B_IMPL AccessorData VarAccessor(v8::Isolate *isolate, V &&var) {
     };
 }
 
+// Data members of primitive types in standard-layout classes are accessed at byte offset,
+// so all such fields of the same type share one getter and setter
+// Offset is measured on local object (see MemberOffset), so only classes constructed and destroyed
+// without user code qualify: trivial ones and aggregates with trivial destructor
+template<typename Member, typename Enable = void>
+struct IsOffsetField : std::false_type {};
+
+template<typename C, typename V>
+struct IsOffsetField<V C::*, std::enable_if_t<std::is_standard_layout_v<C> && std::is_trivially_destructible_v<C> &&
+        (std::is_trivially_default_constructible_v<C> || std::is_aggregate_v<C>) &&
+        (std::is_arithmetic_v<V> || std::is_enum_v<V>)>> : std::true_type {};
+
+struct FieldData {
+    // Type index of class declaring the field, its manager unwraps (and casts) object
+    size_t type_index;
+    size_t offset;
+
+    // Manager is looked up on every access, because it may be removed while binding data lives on
+    void *Unwrap(v8::Isolate *isolate, v8::Local<v8::Object> object) const {
+        auto class_manager = ClassManagerPool::Find(isolate, type_index);
+        if (!class_manager) {
+            throw V8BindException("Class of field is removed from isolate");
+        }
+        return class_manager->UnwrapObject(object);
+    }
+};
+
+template<typename V>
+V8B_IMPL void FieldGetter(v8::Local<v8::String> property, const v8::PropertyCallbackInfo<v8::Value> &info) {
+    try {
+        auto &field = ExternalData::Unwrap<FieldData>(info.Data());
+        auto obj = static_cast<const char *>(field.Unwrap(info.GetIsolate(), info.This()));
+        SetReturnValue(info.GetReturnValue(), info.GetIsolate(), *reinterpret_cast<const V *>(obj + field.offset));
+    } catch (const V8BindException &e) {
+        info.GetIsolate()->ThrowException(v8::Exception::Error(ToV8(info.GetIsolate(), e.what())));
+    }
+}
+
+template<typename V>
+V8B_IMPL void FieldSetter(v8::Local<v8::String> property, v8::Local<v8::Value> value,
+                          const v8::PropertyCallbackInfo<void> &info) {
+    try {
+        auto &field = ExternalData::Unwrap<FieldData>(info.Data());
+        auto obj = static_cast<char *>(field.Unwrap(info.GetIsolate(), info.This()));
+        *reinterpret_cast<V *>(obj + field.offset) = FromV8<V>(info.GetIsolate(), value);
+    } catch (const V8BindException &e) {
+        info.GetIsolate()->ThrowException(v8::Exception::Error(ToV8(info.GetIsolate(), e.what())));
+    }
+}
+
+template<typename Member>
+V8B_IMPL AccessorData FieldAccessor(v8::Isolate *isolate, Member ptr) {
+    using ClassType = typename traits::function_traits<Member>::class_type;
+    using FieldType = typename traits::function_traits<Member>::return_type;
+    using V = std::remove_cv_t<FieldType>;
+
+    AccessorData data {
+            &FieldGetter<V>,
+            nullptr,
+            ExternalData::New(isolate, FieldData { TypeInfo::GetIndexOf<ClassType>(), MemberOffset(ptr) }),
+            v8::PropertyAttribute(v8::DontDelete | v8::ReadOnly)
+    };
+    if constexpr (!std::is_const_v<FieldType>) {
+        data.setter = &FieldSetter<V>;
+        data.attribute = v8::DontDelete;
+    }
+    return data;
+}
+
 template<bool is_member, typename Getter, typename Setter = std::nullptr_t>
 V8B_IMPL AccessorData PropertyAccessor(v8::Isolate *isolate, Getter &&get, Setter &&set) {
     using GetterTrait = typename traits::function_traits<Getter>;
@@ -85,11 +157,11 @@ V8B_IMPL AccessorData PropertyAccessor(v8::Isolate *isolate, Getter &&get, Sette
                               "Getter function must have no arguments");
                 using ClassType = typename std::decay<typename std::tuple_element<0, typename GetterTrait::arguments>::type>::type;
                 auto obj = Class<ClassType>::UnwrapObject(info.GetIsolate(), info.This());
-                info.GetReturnValue().Set(ToV8(info.GetIsolate(), std::invoke(std::get<0>(acc), *obj)));
+                impl::SetReturnValue(info.GetReturnValue(), info.GetIsolate(), std::invoke(std::get<0>(acc), *obj));
             } else {
                 static_assert(std::tuple_size_v<typename GetterTrait::arguments> == 0,
                               "Getter function must have no arguments");
-                info.GetReturnValue().Set(ToV8(info.GetIsolate(), std::invoke(std::get<0>(acc))));
+                impl::SetReturnValue(info.GetReturnValue(), info.GetIsolate(), std::invoke(std::get<0>(acc)));
             }
         } catch (const V8BindException &e) {
             info.GetIsolate()->ThrowException(v8::Exception::Error(ToV8(info.GetIsolate(), e.what())));
@@ -107,6 +179,8 @@ V8B_IMPL AccessorData PropertyAccessor(v8::Isolate *isolate, Getter &&get, Sette
                     static_assert(std::tuple_size_v<typename SetterTrait::arguments> == 2,
                                   "Setter function must have 1 argument");
                     using ClassType = std::decay_t<std::tuple_element_t<0, typename SetterTrait::arguments>>;
+                    impl::ScratchScope<std::tuple_element_t<1, typename SetterTrait::arguments>>
+                            scratch(info.GetIsolate());
                     auto obj = Class<ClassType>::UnwrapObject(info.GetIsolate(), info.This());
                     std::invoke(std::get<1>(acc), *obj,
                                 FromV8<std::tuple_element_t<1, typename SetterTrait::arguments>>(info.GetIsolate(),
@@ -114,6 +188,8 @@ V8B_IMPL AccessorData PropertyAccessor(v8::Isolate *isolate, Getter &&get, Sette
                 } else {
                     static_assert(std::tuple_size_v<typename SetterTrait::arguments> == 1,
                                   "Setter function must have 1 argument");
+                    impl::ScratchScope<std::tuple_element_t<0, typename SetterTrait::arguments>>
+                            scratch(info.GetIsolate());
                     std::invoke(std::get<1>(acc),
                                 FromV8<std::tuple_element_t<0, typename SetterTrait::arguments>>(info.GetIsolate(),
                                                                                                  value));
@@ -0,0 +1,204 @@
+#ifndef SANDWICH_V8B_REGISTRY_HPP
+#define SANDWICH_V8B_REGISTRY_HPP
+
+#include <memory>
+#include <new>
+#include <type_traits>
+#include <utility>
+#include <vector>
+#include <cstddef>
+#include <cstdint>
+
+namespace v8b {
+
+// Open addressing hash table keyed by non-null pointers
+// Linear probing, deletion shifts following entries back, so there are no tombstones
+template<typename V>
+class PointerTable {
+    struct Slot {
+        const void *key;
+        V value;
+    };
+
+    std::unique_ptr<Slot[]> slots;
+    size_t capacity = 0;
+    size_t size = 0;
+
+    [[nodiscard]]
+    size_t Home(const void *key) const {
+        // Fibonacci hashing, low bits of pointer are mostly zero because of alignment
+        auto h = static_cast<uint64_t>(reinterpret_cast<uintptr_t>(key)) * 0x9E3779B97F4A7C15ull;
+        return static_cast<size_t>(h >> 32u) & (capacity - 1);
+    }
+
+    void Rehash(size_t new_capacity) {
+        auto old_slots = std::move(slots);
+        auto old_capacity = capacity;
+        slots.reset(new Slot[new_capacity]());
+        capacity = new_capacity;
+        for (size_t i = 0; i < old_capacity; ++i) {
+            if (old_slots[i].key) {
+                auto j = Home(old_slots[i].key);
+                while (slots[j].key) {
+                    j = (j + 1) & (capacity - 1);
+                }
+                slots[j] = std::move(old_slots[i]);
+            }
+        }
+    }
+
+    // Returns capacity if key isn't present
+    [[nodiscard]]
+    size_t IndexOf(const void *key) const {
+        if (!size) {
+            return capacity;
+        }
+        for (auto i = Home(key); slots[i].key; i = (i + 1) & (capacity - 1)) {
+            if (slots[i].key == key) {
+                return i;
+            }
+        }
+        return capacity;
+    }
+
+public:
+    PointerTable() = default;
+    PointerTable(PointerTable &&other) noexcept
+            : slots(std::move(other.slots)), capacity(other.capacity), size(other.size) {
+        other.capacity = 0;
+        other.size = 0;
+    }
+
+    PointerTable &operator=(PointerTable &&other) noexcept {
+        slots = std::move(other.slots);
+        capacity = other.capacity;
+        size = other.size;
+        other.capacity = 0;
+        other.size = 0;
+        return *this;
+    }
+
+    [[nodiscard]]
+    V *Find(const void *key) const {
+        auto i = IndexOf(key);
+        return i == capacity ? nullptr : &slots[i].value;
+    }
+
+    // Returns false if key is already present (value isn't replaced then)
+    bool Insert(const void *key, V value) {
+        // Keep load factor under 3/4
+        if ((size + 1) * 4 > capacity * 3) {
+            Rehash(capacity ? capacity * 2 : 16);
+        }
+        auto i = Home(key);
+        for (; slots[i].key; i = (i + 1) & (capacity - 1)) {
+            if (slots[i].key == key) {
+                return false;
+            }
+        }
+        slots[i] = Slot { key, std::move(value) };
+        ++size;
+        return true;
+    }
+
+    // Make room for count more entries without rehashing
+    void Reserve(size_t count) {
+        auto new_capacity = capacity ? capacity : 16;
+        while ((size + count) * 4 > new_capacity * 3) {
+            new_capacity *= 2;
+        }
+        if (new_capacity != capacity) {
+            Rehash(new_capacity);
+        }
+    }
+
+    bool Erase(const void *key) {
+        auto i = IndexOf(key);
+        if (i == capacity) {
+            return false;
+        }
+        auto mask = capacity - 1;
+        // Move back entries which can't be found anymore after slot i is emptied
+        for (auto j = (i + 1) & mask; slots[j].key; j = (j + 1) & mask) {
+            auto home = Home(slots[j].key);
+            if (((j - home) & mask) >= ((j - i) & mask)) {
+                slots[i] = std::move(slots[j]);
+                i = j;
+            }
+        }
+        slots[i] = Slot();
+        --size;
+        return true;
+    }
+
+    void Clear() {
+        slots.reset();
+        capacity = 0;
+        size = 0;
+    }
+
+    [[nodiscard]]
+    size_t Size() const {
+        return size;
+    }
+
+    template<typename F>
+    void ForEach(F &&f) const {
+        for (size_t i = 0; i < capacity; ++i) {
+            if (slots[i].key) {
+                f(const_cast<void *>(slots[i].key), slots[i].value);
+            }
+        }
+    }
+};
+
+// Allocates objects in chunks and reuses freed ones, addresses are stable
+template<typename T>
+class ObjectPool {
+    union Node {
+        Node *next;
+        alignas(T) unsigned char storage[sizeof(T)];
+    };
+
+    std::vector<std::unique_ptr<Node[]>> chunks;
+    Node *free_list = nullptr;
+    size_t chunk_size = 16;
+
+public:
+    ObjectPool() = default;
+    ObjectPool(const ObjectPool &) = delete;
+    ObjectPool &operator=(const ObjectPool &) = delete;
+    ObjectPool(ObjectPool &&) noexcept = default;
+    ObjectPool &operator=(ObjectPool &&) noexcept = default;
+
+    // Objects not returned with Delete are not destroyed with pool
+    template<typename ...Args>
+    T *New(Args&&... args) {
+        if (!free_list) {
+            // Chunks grow geometrically up to fixed size
+            chunks.emplace_back(new Node[chunk_size]);
+            auto chunk = chunks.back().get();
+            for (size_t i = 0; i < chunk_size; ++i) {
+                chunk[i].next = i + 1 < chunk_size ? &chunk[i + 1] : nullptr;
+            }
+            free_list = chunk;
+            if (chunk_size < 1024) {
+                chunk_size *= 2;
+            }
+        }
+        auto node = free_list;
+        free_list = node->next;
+        return new (node->storage) T { std::forward<Args>(args)... };
+    }
+
+    void Delete(T *object) {
+        object->~T();
+        auto node = reinterpret_cast<Node *>(object);
+        node->next = free_list;
+        free_list = node;
+    }
+};
+
+}
+
+#endif //SANDWICH_V8B_REGISTRY_HPP
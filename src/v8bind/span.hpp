@@ -0,0 +1,62 @@
+#ifndef SANDWICH_V8B_SPAN_HPP
+#define SANDWICH_V8B_SPAN_HPP
+
+#include <type_traits>
+#include <utility>
+#include <cstddef>
+
+namespace v8b {
+
+// Non-owning view of contiguous elements (std::span isn't available in C++17)
+// As function parameter it points directly into memory of passed ArrayBuffer or typed array
+template<typename T>
+class Span {
+public:
+    using element_type = T;
+    using value_type = std::remove_cv_t<T>;
+    using iterator = T *;
+
+    constexpr Span() noexcept = default;
+    constexpr Span(T *elements, size_t count) noexcept : elements(elements), count(count) {}
+
+    // From any container with contiguous storage (std::vector, std::array, Span<U> with less const)
+    template<typename Container, typename = std::enable_if_t<std::is_convertible_v<
+            decltype(std::declval<Container &>().data()), T *>>>
+    constexpr Span(Container &container) noexcept : elements(container.data()), count(container.size()) {}
+
+    constexpr T *data() const noexcept {
+        return elements;
+    }
+
+    constexpr size_t size() const noexcept {
+        return count;
+    }
+
+    constexpr size_t size_bytes() const noexcept {
+        return count * sizeof(T);
+    }
+
+    constexpr bool empty() const noexcept {
+        return count == 0;
+    }
+
+    constexpr T &operator[](size_t index) const {
+        return elements[index];
+    }
+
+    constexpr iterator begin() const noexcept {
+        return elements;
+    }
+
+    constexpr iterator end() const noexcept {
+        return elements + count;
+    }
+
+private:
+    T *elements = nullptr;
+    size_t count = 0;
+};
+
+}
+
+#endif //SANDWICH_V8B_SPAN_HPP
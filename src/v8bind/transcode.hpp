@@ -0,0 +1,430 @@
+#ifndef SANDWICH_V8B_TRANSCODE_HPP
+#define SANDWICH_V8B_TRANSCODE_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+
+// SSE4.1 and AVX2 transcoders are compiled with GCC and Clang on x86 and selected at runtime
+// by CPU features, set to 0 to use only portable scalar code
+#if !defined(V8B_TRANSCODE_SIMD)
+    #if (defined(__GNUC__) || defined(__clang__)) && (defined(__x86_64__) || defined(__i386__))
+        #define V8B_TRANSCODE_SIMD 1
+    #else
+        #define V8B_TRANSCODE_SIMD 0
+    #endif
+#endif
+
+#if V8B_TRANSCODE_SIMD
+    #include <immintrin.h>
+#endif
+
+// Transcoding between V8 string representations (Latin-1 and UTF-16) and UTF-32 (or UTF-8)
+// Input is processed in blocks, only blocks with surrogates (or code points out of BMP)
+// take scalar path
+// Invalid input (lone surrogates, code points out of Unicode range) is replaced with U+FFFD
+namespace v8b::impl::transcode {
+
+constexpr char32_t replacement_character = 0xFFFD;
+
+inline bool IsSurrogate(uint32_t c) {
+    return (c & 0xFFFFF800u) == 0xD800u;
+}
+
+// Decodes src from i up to end (surrogate pair may end one unit later) into dst from j
+// Returns position in src where it stopped
+inline size_t DecodeUtf16(const uint16_t *src, size_t length, size_t i, size_t end, char32_t *dst, size_t &j) {
+    while (i < end) {
+        uint32_t c = src[i++];
+        if (IsSurrogate(c)) {
+            if (c < 0xDC00u && i < length && (src[i] & 0xFC00u) == 0xDC00u) {
+                c = 0x10000u + ((c - 0xD800u) << 10u) + (src[i++] - 0xDC00u);
+            } else {
+                c = replacement_character;
+            }
+        }
+        dst[j++] = c;
+    }
+    return i;
+}
+
+// Encodes src from i up to end into dst from j
+inline void EncodeUtf16(const char32_t *src, size_t i, size_t end, uint16_t *dst, size_t &j) {
+    for (; i < end; ++i) {
+        uint32_t c = src[i];
+        if (c >= 0x10000u && c < 0x110000u) {
+            c -= 0x10000u;
+            dst[j++] = static_cast<uint16_t>(0xD800u + (c >> 10u));
+            dst[j++] = static_cast<uint16_t>(0xDC00u + (c & 0x3FFu));
+        } else {
+            dst[j++] = static_cast<uint16_t>(c >= 0x10000u || IsSurrogate(c) ? replacement_character : c);
+        }
+    }
+}
+
+// Portable implementation, blocks are written with branch-free loops for autovectorization
+namespace scalar {
+
+constexpr size_t block_size = 16;
+
+inline void Latin1ToUtf32(const uint8_t *src, size_t length, char32_t *dst) {
+    for (size_t i = 0; i < length; ++i) {
+        dst[i] = src[i];
+    }
+}
+
+inline size_t Utf16ToUtf32(const uint16_t *src, size_t length, char32_t *dst) {
+    size_t i = 0, j = 0;
+    while (i < length) {
+        if (i + block_size <= length) {
+            bool has_surrogates = false;
+            for (size_t k = 0; k < block_size; ++k) {
+                has_surrogates |= IsSurrogate(src[i + k]);
+            }
+            if (!has_surrogates) {
+                for (size_t k = 0; k < block_size; ++k) {
+                    dst[j + k] = src[i + k];
+                }
+                i += block_size;
+                j += block_size;
+                continue;
+            }
+        }
+        i = DecodeUtf16(src, length, i, i + block_size < length ? i + block_size : length, dst, j);
+    }
+    return j;
+}
+
+inline uint32_t Utf32Mask(const char32_t *src, size_t length) {
+    uint32_t mask = 0;
+    for (size_t i = 0; i < length; ++i) {
+        mask |= src[i];
+    }
+    return mask;
+}
+
+inline void Utf32ToLatin1(const char32_t *src, size_t length, uint8_t *dst) {
+    for (size_t i = 0; i < length; ++i) {
+        dst[i] = static_cast<uint8_t>(src[i]);
+    }
+}
+
+inline size_t Utf32ToUtf16(const char32_t *src, size_t length, uint16_t *dst) {
+    size_t i = 0, j = 0;
+    while (i < length) {
+        if (i + block_size <= length) {
+            uint32_t mask = 0;
+            for (size_t k = 0; k < block_size; ++k) {
+                mask |= src[i + k];
+            }
+            if (mask < 0x10000u) {
+                for (size_t k = 0; k < block_size; ++k) {
+                    uint32_t c = src[i + k];
+                    dst[j + k] = static_cast<uint16_t>(IsSurrogate(c) ? replacement_character : c);
+                }
+                i += block_size;
+                j += block_size;
+                continue;
+            }
+        }
+        size_t end = i + block_size < length ? i + block_size : length;
+        EncodeUtf16(src, i, end, dst, j);
+        i = end;
+    }
+    return j;
+}
+
+} // namespace scalar
+
+#if V8B_TRANSCODE_SIMD
+
+#define V8B_TARGET(isa) __attribute__((target(isa)))
+
+// 16 bytes (or 8 code units, or 4 code points) per register
+namespace sse41 {
+
+V8B_TARGET("sse4.1") inline void Latin1ToUtf32(const uint8_t *src, size_t length, char32_t *dst) {
+    size_t i = 0;
+    for (; i + 16 <= length; i += 16) {
+        auto v = _mm_loadu_si128(reinterpret_cast<const __m128i *>(src + i));
+        auto out = reinterpret_cast<__m128i *>(dst + i);
+        _mm_storeu_si128(out, _mm_cvtepu8_epi32(v));
+        _mm_storeu_si128(out + 1, _mm_cvtepu8_epi32(_mm_srli_si128(v, 4)));
+        _mm_storeu_si128(out + 2, _mm_cvtepu8_epi32(_mm_srli_si128(v, 8)));
+        _mm_storeu_si128(out + 3, _mm_cvtepu8_epi32(_mm_srli_si128(v, 12)));
+    }
+    scalar::Latin1ToUtf32(src + i, length - i, dst + i);
+}
+
+V8B_TARGET("sse4.1") inline size_t Utf16ToUtf32(const uint16_t *src, size_t length, char32_t *dst) {
+    const auto surrogate_mask = _mm_set1_epi16(static_cast<short>(0xF800));
+    const auto surrogate_bits = _mm_set1_epi16(static_cast<short>(0xD800));
+    size_t i = 0, j = 0;
+    while (i < length) {
+        if (i + 8 <= length) {
+            auto v = _mm_loadu_si128(reinterpret_cast<const __m128i *>(src + i));
+            auto surrogates = _mm_cmpeq_epi16(_mm_and_si128(v, surrogate_mask), surrogate_bits);
+            if (!_mm_movemask_epi8(surrogates)) {
+                auto out = reinterpret_cast<__m128i *>(dst + j);
+                _mm_storeu_si128(out, _mm_cvtepu16_epi32(v));
+                _mm_storeu_si128(out + 1, _mm_cvtepu16_epi32(_mm_srli_si128(v, 8)));
+                i += 8;
+                j += 8;
+                continue;
+            }
+        }
+        i = DecodeUtf16(src, length, i, i + 8 < length ? i + 8 : length, dst, j);
+    }
+    return j;
+}
+
+V8B_TARGET("sse4.1") inline uint32_t Utf32Mask(const char32_t *src, size_t length) {
+    auto mask = _mm_setzero_si128();
+    size_t i = 0;
+    for (; i + 4 <= length; i += 4) {
+        mask = _mm_or_si128(mask, _mm_loadu_si128(reinterpret_cast<const __m128i *>(src + i)));
+    }
+    mask = _mm_or_si128(mask, _mm_srli_si128(mask, 8));
+    mask = _mm_or_si128(mask, _mm_srli_si128(mask, 4));
+    return static_cast<uint32_t>(_mm_cvtsi128_si32(mask)) | scalar::Utf32Mask(src + i, length - i);
+}
+
+V8B_TARGET("sse4.1") inline void Utf32ToLatin1(const char32_t *src, size_t length, uint8_t *dst) {
+    size_t i = 0;
+    for (; i + 16 <= length; i += 16) {
+        auto in = reinterpret_cast<const __m128i *>(src + i);
+        // Code points are below 0x100, so saturation doesn't change them
+        auto low = _mm_packus_epi32(_mm_loadu_si128(in), _mm_loadu_si128(in + 1));
+        auto high = _mm_packus_epi32(_mm_loadu_si128(in + 2), _mm_loadu_si128(in + 3));
+        _mm_storeu_si128(reinterpret_cast<__m128i *>(dst + i), _mm_packus_epi16(low, high));
+    }
+    scalar::Utf32ToLatin1(src + i, length - i, dst + i);
+}
+
+V8B_TARGET("sse4.1") inline size_t Utf32ToUtf16(const char32_t *src, size_t length, uint16_t *dst) {
+    const auto surrogate_mask = _mm_set1_epi32(static_cast<int>(0xFFFFF800u));
+    const auto surrogate_bits = _mm_set1_epi32(0xD800);
+    size_t i = 0, j = 0;
+    while (i < length) {
+        if (i + 8 <= length) {
+            auto in = reinterpret_cast<const __m128i *>(src + i);
+            auto a = _mm_loadu_si128(in), b = _mm_loadu_si128(in + 1);
+            // Non-zero lanes are surrogates or code points out of BMP
+            auto special = _mm_or_si128(
+                    _mm_or_si128(_mm_cmpeq_epi32(_mm_and_si128(a, surrogate_mask), surrogate_bits),
+                                 _mm_cmpeq_epi32(_mm_and_si128(b, surrogate_mask), surrogate_bits)),
+                    _mm_srli_epi32(_mm_or_si128(a, b), 16));
+            if (_mm_testz_si128(special, special)) {
+                _mm_storeu_si128(reinterpret_cast<__m128i *>(dst + j), _mm_packus_epi32(a, b));
+                i += 8;
+                j += 8;
+                continue;
+            }
+        }
+        size_t end = i + 8 < length ? i + 8 : length;
+        EncodeUtf16(src, i, end, dst, j);
+        i = end;
+    }
+    return j;
+}
+
+} // namespace sse41
+
+// 32 bytes (or 16 code units, or 8 code points) per register
+namespace avx2 {
+
+V8B_TARGET("avx2") inline void Latin1ToUtf32(const uint8_t *src, size_t length, char32_t *dst) {
+    size_t i = 0;
+    for (; i + 16 <= length; i += 16) {
+        auto v = _mm_loadu_si128(reinterpret_cast<const __m128i *>(src + i));
+        auto out = reinterpret_cast<__m256i *>(dst + i);
+        _mm256_storeu_si256(out, _mm256_cvtepu8_epi32(v));
+        _mm256_storeu_si256(out + 1, _mm256_cvtepu8_epi32(_mm_srli_si128(v, 8)));
+    }
+    scalar::Latin1ToUtf32(src + i, length - i, dst + i);
+}
+
+V8B_TARGET("avx2") inline size_t Utf16ToUtf32(const uint16_t *src, size_t length, char32_t *dst) {
+    const auto surrogate_mask = _mm256_set1_epi16(static_cast<short>(0xF800));
+    const auto surrogate_bits = _mm256_set1_epi16(static_cast<short>(0xD800));
+    size_t i = 0, j = 0;
+    while (i < length) {
+        if (i + 16 <= length) {
+            auto v = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(src + i));
+            auto surrogates = _mm256_cmpeq_epi16(_mm256_and_si256(v, surrogate_mask), surrogate_bits);
+            if (!_mm256_movemask_epi8(surrogates)) {
+                auto out = reinterpret_cast<__m256i *>(dst + j);
+                _mm256_storeu_si256(out, _mm256_cvtepu16_epi32(_mm256_castsi256_si128(v)));
+                _mm256_storeu_si256(out + 1, _mm256_cvtepu16_epi32(_mm256_extracti128_si256(v, 1)));
+                i += 16;
+                j += 16;
+                continue;
+            }
+        }
+        i = DecodeUtf16(src, length, i, i + 16 < length ? i + 16 : length, dst, j);
+    }
+    return j;
+}
+
+V8B_TARGET("avx2") inline uint32_t Utf32Mask(const char32_t *src, size_t length) {
+    auto mask = _mm256_setzero_si256();
+    size_t i = 0;
+    for (; i + 8 <= length; i += 8) {
+        mask = _mm256_or_si256(mask, _mm256_loadu_si256(reinterpret_cast<const __m256i *>(src + i)));
+    }
+    auto half = _mm_or_si128(_mm256_castsi256_si128(mask), _mm256_extracti128_si256(mask, 1));
+    half = _mm_or_si128(half, _mm_srli_si128(half, 8));
+    half = _mm_or_si128(half, _mm_srli_si128(half, 4));
+    return static_cast<uint32_t>(_mm_cvtsi128_si32(half)) | scalar::Utf32Mask(src + i, length - i);
+}
+
+V8B_TARGET("avx2") inline void Utf32ToLatin1(const char32_t *src, size_t length, uint8_t *dst) {
+    size_t i = 0;
+    for (; i + 16 <= length; i += 16) {
+        auto in = reinterpret_cast<const __m256i *>(src + i);
+        // Packing works within 128-bit lanes, permutation puts 16-bit values back in order
+        auto words = _mm256_permute4x64_epi64(
+                _mm256_packus_epi32(_mm256_loadu_si256(in), _mm256_loadu_si256(in + 1)), 0xD8);
+        _mm_storeu_si128(reinterpret_cast<__m128i *>(dst + i),
+                _mm_packus_epi16(_mm256_castsi256_si128(words), _mm256_extracti128_si256(words, 1)));
+    }
+    scalar::Utf32ToLatin1(src + i, length - i, dst + i);
+}
+
+V8B_TARGET("avx2") inline size_t Utf32ToUtf16(const char32_t *src, size_t length, uint16_t *dst) {
+    const auto surrogate_mask = _mm256_set1_epi32(static_cast<int>(0xFFFFF800u));
+    const auto surrogate_bits = _mm256_set1_epi32(0xD800);
+    size_t i = 0, j = 0;
+    while (i < length) {
+        if (i + 16 <= length) {
+            auto in = reinterpret_cast<const __m256i *>(src + i);
+            auto a = _mm256_loadu_si256(in), b = _mm256_loadu_si256(in + 1);
+            auto special = _mm256_or_si256(
+                    _mm256_or_si256(_mm256_cmpeq_epi32(_mm256_and_si256(a, surrogate_mask), surrogate_bits),
+                                    _mm256_cmpeq_epi32(_mm256_and_si256(b, surrogate_mask), surrogate_bits)),
+                    _mm256_srli_epi32(_mm256_or_si256(a, b), 16));
+            if (_mm256_testz_si256(special, special)) {
+                _mm256_storeu_si256(reinterpret_cast<__m256i *>(dst + j),
+                        _mm256_permute4x64_epi64(_mm256_packus_epi32(a, b), 0xD8));
+                i += 16;
+                j += 16;
+                continue;
+            }
+        }
+        size_t end = i + 16 < length ? i + 16 : length;
+        EncodeUtf16(src, i, end, dst, j);
+        i = end;
+    }
+    return j;
+}
+
+} // namespace avx2
+
+#undef V8B_TARGET
+
+enum class Isa {
+    scalar,
+    sse41,
+    avx2
+};
+
+// Best instruction set supported by CPU, detected once
+inline Isa GetIsa() {
+    static const Isa isa = [] {
+        __builtin_cpu_init();
+        if (__builtin_cpu_supports("avx2")) {
+            return Isa::avx2;
+        }
+        if (__builtin_cpu_supports("sse4.1")) {
+            return Isa::sse41;
+        }
+        return Isa::scalar;
+    }();
+    return isa;
+}
+
+#define V8B_TRANSCODE_DISPATCH(function, ...) \
+    switch (GetIsa()) { \
+        case Isa::avx2: return avx2::function(__VA_ARGS__); \
+        case Isa::sse41: return sse41::function(__VA_ARGS__); \
+        default: return scalar::function(__VA_ARGS__); \
+    }
+
+#else
+
+#define V8B_TRANSCODE_DISPATCH(function, ...) return scalar::function(__VA_ARGS__);
+
+#endif
+
+inline void Latin1ToUtf32(const uint8_t *src, size_t length, char32_t *dst) {
+    V8B_TRANSCODE_DISPATCH(Latin1ToUtf32, src, length, dst)
+}
+
+// Returns number of code points written, dst should have room for length code points
+inline size_t Utf16ToUtf32(const uint16_t *src, size_t length, char32_t *dst) {
+    V8B_TRANSCODE_DISPATCH(Utf16ToUtf32, src, length, dst)
+}
+
+// Bitwise OR of all code points, tells the narrowest representation fitting all of them
+inline uint32_t Utf32Mask(const char32_t *src, size_t length) {
+    V8B_TRANSCODE_DISPATCH(Utf32Mask, src, length)
+}
+
+// All code points should be below 0x100
+inline void Utf32ToLatin1(const char32_t *src, size_t length, uint8_t *dst) {
+    V8B_TRANSCODE_DISPATCH(Utf32ToLatin1, src, length, dst)
+}
+
+// Returns number of code units written, dst should have room for 2 * length code units
+inline size_t Utf32ToUtf16(const char32_t *src, size_t length, uint16_t *dst) {
+    V8B_TRANSCODE_DISPATCH(Utf32ToUtf16, src, length, dst)
+}
+
+#undef V8B_TRANSCODE_DISPATCH
+
+// Number of UTF-8 bytes for Latin-1 text, characters above 0x7F take two bytes
+inline size_t Latin1Utf8Length(const uint8_t *src, size_t length) {
+    size_t size = length;
+    size_t i = 0;
+    for (; i + sizeof(uint64_t) <= length; i += sizeof(uint64_t)) {
+        uint64_t word;
+        std::memcpy(&word, src + i, sizeof(word));
+        // High bits moved to lowest bit of each byte and summed into the top byte
+        size += static_cast<size_t>((((word >> 7) & 0x0101010101010101ull) * 0x0101010101010101ull) >> 56);
+    }
+    for (; i < length; ++i) {
+        size += src[i] >> 7;
+    }
+    return size;
+}
+
+// Expands Latin-1 text at the beginning of buffer to UTF-8 of size bytes (see Latin1Utf8Length)
+// Goes from the end, so characters are read before they're overwritten, ASCII words are moved
+// at once and ASCII prefix (already in place) isn't touched
+inline void Latin1ToUtf8InPlace(uint8_t *buffer, size_t length, size_t size) {
+    auto dst = buffer + size;
+    size_t i = length;
+    while (dst != buffer + i) {
+        if (i >= sizeof(uint64_t)) {
+            uint64_t word;
+            std::memcpy(&word, buffer + i - sizeof(word), sizeof(word));
+            if (!(word & 0x8080808080808080ull)) {
+                dst -= sizeof(word);
+                i -= sizeof(word);
+                std::memcpy(dst, &word, sizeof(word));
+                continue;
+            }
+        }
+        uint8_t c = buffer[--i];
+        if (c < 0x80) {
+            *--dst = c;
+        } else {
+            *--dst = static_cast<uint8_t>(0x80u | (c & 0x3Fu));
+            *--dst = static_cast<uint8_t>(0xC0u | (c >> 6));
+        }
+    }
+}
+
+}
+
+#endif //SANDWICH_V8B_TRANSCODE_HPP
@@ -5,10 +5,10 @@
 #ifndef SANDWICH_V8B_TYPE_INFO_HPP
 #define SANDWICH_V8B_TYPE_INFO_HPP
 
+#include <atomic>
 #include <functional>
 #include <string>
 #include <type_traits>
-#include <cstring>
 
 // Check RTTI
 #if defined(__clang__)
@@ -52,12 +52,13 @@ struct TypeInfo {
 #endif
 
     TypeInfo(const TypeInfo &other)
-            : type_id(other.type_id), size(other.size), name(other.name) {}
+            : type_id(other.type_id), size(other.size), name(other.name), index(other.index) {}
 
     TypeInfo &operator=(const TypeInfo &other) {
         type_id = other.type_id;
         size = other.size;
         name = other.name;
+        index = other.index;
         return *this;
     }
 
@@ -100,15 +101,26 @@ struct TypeInfo {
         return name;
     }
 
+    // Dense index assigned to type at first use, suitable for table lookups
+    [[nodiscard]]
+    size_t GetIndex() const {
+        return index;
+    }
+
+    template<typename T>
+    static size_t GetIndexOf() {
+        return IndexOf<std::decay_t<T>>();
+    }
+
 #if defined(RTTI_ENABLED)
     template<typename T>
     static TypeInfo Get() {
-        return TypeInfo(std::type_index(typeid(T)), sizeof(T), GetName<T>());
+        return TypeInfo(std::type_index(typeid(T)), sizeof(T), GetName<T>(), GetIndexOf<T>());
     }
 
     template<typename T>
     static TypeInfo Get(T &&t) {
-        return TypeInfo(std::type_index(typeid(std::forward<T>(t))), sizeof(T), GetName<T>());
+        return TypeInfo(std::type_index(typeid(std::forward<T>(t))), sizeof(T), GetName<T>(), GetIndexOf<T>());
     }
 #else
     template<typename T>
@@ -131,18 +143,25 @@ private:
     TypeId type_id;
     size_t size;
     const char *name;
+    size_t index;
 
-    explicit TypeInfo(TypeId type_id, size_t size, const char *name)
-        : type_id(type_id), size(size), name(name) {}
+    inline static std::atomic<size_t> next_index { 0 };
+
+    explicit TypeInfo(TypeId type_id, size_t size, const char *name, size_t index)
+        : type_id(type_id), size(size), name(name), index(index) {}
+
+    template<typename T>
+    static size_t IndexOf() {
+        static const size_t index = next_index.fetch_add(1, std::memory_order_relaxed);
+        return index;
+    }
 
     template<typename T>
     static const char *GetName() {
-        static const size_t size = sizeof(UNIQUE_FUNCTION_ID) - FUNCTION_FRONT_DISCARD_SIZE - FUNCTION_BACK_DISCARD_SIZE;
-        static char name[size] = {};
-        if (!name[0]) {
-            std::memcpy(name, UNIQUE_FUNCTION_ID + FUNCTION_FRONT_DISCARD_SIZE, size - 1u);
-        }
-        return name;
+        // Static initialization is thread safe, unlike lazy filling of buffer
+        static const std::string name(UNIQUE_FUNCTION_ID + FUNCTION_FRONT_DISCARD_SIZE,
+                sizeof(UNIQUE_FUNCTION_ID) - FUNCTION_FRONT_DISCARD_SIZE - FUNCTION_BACK_DISCARD_SIZE - 1u);
+        return name.c_str();
     }
 
 #if !defined(RTTI_ENABLED)
@@ -155,7 +174,7 @@ private:
     template<typename T>
     static TypeInfo GetImpl() {
         constexpr size_t hash = ConstStringHash(UNIQUE_FUNCTION_ID);
-        return TypeInfo(hash, sizeof(T), GetName<T>());
+        return TypeInfo(hash, sizeof(T), GetName<T>(), GetIndexOf<T>());
     }
 #endif
 };